@@ -32,19 +32,21 @@ struct SAnim	pAnmSlots[ANM_MAX_SLOTS];
 u32	gnAnmLastUsed;
 
 
-#ifdef DEBUG_DISP
-// debug.
-void anm_tst_dispnb(u32 nPosY)
+// Nb de slots utiliss (profiler).
+u32 AnmSlotsUsedNb(void)
 {
 	u32	i, k;
-	// Compte.
+
 	for (i = 0, k = 0; i < ANM_MAX_SLOTS; i++) if (pAnmSlots[i].nUsed) k++;
-	// Affichage.
-	char	pTb[4+8+1] = "ANM:00000000";
-	MyItoA(k, pTb);
-	Font_Print(10, nPosY, pTb, 0);
+	return (k);
+}
+
+// Snapshots : Slots d'anims.
+void AnmSnapZones(void)
+{
+	SnapZoneAdd(pAnmSlots, sizeof(pAnmSlots), NULL, NULL);
+	SnapZoneAdd(&gnAnmLastUsed, sizeof(gnAnmLastUsed), NULL, NULL);
 }
-#endif
 
 
 // RAZ moteur.
@@ -204,11 +206,11 @@ s32 AnmGetImage(s32 nSlotNo)
 				pAnmSlots[nSlotNo].pAnm += *(s64 *)(pAnmSlots[nSlotNo].pAnm + 1);// * 2;
 				break;
 			case e_Anm_RndJump:	// Jump en fct d'un RND. / Jump alatoire. e_Anm_RndJump, proba (sur 255), offs si <, offs si >.
-				pAnmSlots[nSlotNo].pAnm += *(s64 *)(pAnmSlots[nSlotNo].pAnm + ((rand() & 0xFF) < *(pAnmSlots[nSlotNo].pAnm + 1) ? 2 : 3));
+				pAnmSlots[nSlotNo].pAnm += *(s64 *)(pAnmSlots[nSlotNo].pAnm + ((Rnd() & 0xFF) < *(pAnmSlots[nSlotNo].pAnm + 1) ? 2 : 3));
 				break;
 
 			case e_Anm_RndGoto:	// Saute  une anim ou  une autre en fonction d'un RND. / e_Anm_RndGoto, proba, adr si <, adr si >.
-				pAnmSlots[nSlotNo].pAnm += ((rand() & 0xFF) < *(pAnmSlots[nSlotNo].pAnm + 1) ? 1 : 2);
+				pAnmSlots[nSlotNo].pAnm += ((Rnd() & 0xFF) < *(pAnmSlots[nSlotNo].pAnm + 1) ? 1 : 2);
 			case e_Anm_Goto:	// Fait sauter le pointeur  une autre adresse.
 				pAnmSlots[nSlotNo].pAnm = (u64 *)*(pAnmSlots[nSlotNo].pAnm + 1);
 				pAnmSlots[nSlotNo].pOrg = pAnmSlots[nSlotNo].pAnm;
@@ -10,5 +10,7 @@ u32 AnmGetKey(s32 nSlotNo);
 u32 AnmCheckEnd(s32 nSlotNo);
 u32 AnmCheckStepFlag(s32 nSlotNo);
 u32 AnmCheckNewImgFlag(s32 nSlotNo);
+u32 AnmSlotsUsedNb(void);
+void AnmSnapZones(void);
 
 
@@ -0,0 +1,80 @@
+#!/bin/sh
+# Benchmark : Rejoue le corpus (bench/corpus.txt) en headless et compare a la baseline.
+# Usage : bench/bench.sh <exe>  (a lancer depuis minislug0, pour les gfx).
+# BENCH_THRESHOLD : Regression toleree, en % (defaut 10).
+# BENCH_NOCMP=1 : Pas de comparaison (pour refaire la baseline).
+# La baseline (temps absolus) n'a de sens que sur la machine qui l'a faite : Elle n'est pas dans le depot, make bench-baseline
+# la cree en local (avant les modifs a mesurer).
+# Echec (code de sortie 1) : enregistrement manquant, rejeu en erreur (desynchro, image differente), aucun rejeu,
+# pas de baseline, ou regression.
+# BENCH_FLAGS : Options en plus de -headless (ex : -norender, -noraster).
+
+EXE=${1:-./minislug}
+DIR=bench
+OUT=$DIR/results.json
+BASE=$DIR/baseline.json
+TH=${BENCH_THRESHOLD:-10}
+TMP=$DIR/.run.json
+FAIL=0
+NRUN=0
+
+# Resultats : Un objet par ligne.
+echo "[" > $OUT
+SEP=""
+for NAME in $(grep -v '^#' $DIR/corpus.txt); do
+	REP=$DIR/$NAME.rep
+	if [ ! -f $REP ]; then
+		echo "bench: $REP missing."
+		FAIL=1
+		continue
+	fi
+	rm -f $TMP
+	if ! $EXE -headless $BENCH_FLAGS -replay $REP -json $TMP > /dev/null || [ ! -f $TMP ]; then
+		echo "bench: $NAME: replay failed (desync or screen mismatch)."
+		FAIL=1
+		continue
+	fi
+	printf '%s{"name":"%s",%s\n' "$SEP" "$NAME" "$(sed 's/^{//' $TMP)" >> $OUT
+	SEP=","
+	NRUN=$((NRUN + 1))
+done
+echo "]" >> $OUT
+rm -f $TMP
+
+if [ $NRUN -eq 0 ]; then
+	echo "bench: No replay run."
+	exit 1
+fi
+if [ "$BENCH_NOCMP" = "1" ]; then
+	exit $FAIL
+fi
+if [ ! -f $BASE ]; then
+	echo "bench: No baseline ($BASE). make bench-baseline to create it."
+	exit 1
+fi
+
+# Comparaison : temps de frame (p50, p99), memoire, mixer audio. Plus haut = plus mauvais.
+awk -v th=$TH '
+function val(s, k,    r) {
+	if (match(s, "\"" k "\":[0-9.]+") == 0) return (-1);
+	r = substr(s, RSTART, RLENGTH); sub(/.*:/, "", r); return (r + 0);
+}
+function name(s,    r) { match(s, /"name":"[^"]*"/); r = substr(s, RSTART + 8, RLENGTH - 9); return (r); }
+FNR == NR { if ($0 ~ /"name"/) base[name($0)] = $0; next; }
+$0 ~ /"name"/ {
+	n = name($0);
+	if (!(n in base)) { printf("bench: %s: not in baseline.\n", n); bad = 1; next; }
+	split("frame_p50_us frame_p99_us peak_mem_kb audio_mix_us", keys, " ");
+	for (i = 1; i <= 4; i++) {
+		b = val(base[n], keys[i]); c = val($0, keys[i]);
+		if (b <= 0 || c < 0) continue;
+		d = (c - b) * 100 / b;
+		st = (d > th ? "REGRESSION" : "ok");
+		if (d > th) bad = 1;
+		printf("bench: %-8s %-14s %10.1f -> %10.1f (%+6.1f %%) %s\n", n, keys[i], b, c, d, st);
+	}
+}
+END { exit (bad); }
+' $BASE $OUT || FAIL=1
+
+exit $FAIL
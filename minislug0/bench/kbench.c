@@ -0,0 +1,452 @@
+
+// Microbenchmarks des routines critiques du moteur, hors jeu.
+// Binaire  part (make kbench), li avec les objets du jeu (main.c est recompil sans son main()).
+// A lancer depuis le rpertoire du jeu (gfx/, lev*/, sfx/).
+// Chaque routine est appele en boucle jusqu' dpasser la dure minimale, on affiche le temps par appel et le dbit.
+//
+// Options :
+// -ms <n>     : Dure minimale de mesure d'une routine, en ms.
+// -only <str> : Seulement les routines dont le nom contient <str>.
+// -level <n>  : Niveau utilis pour le scroll et LevelLoad (0 = premier niveau du jeu).
+// -spr <n>    : N du sprite utilis pour les sprites.
+
+#include "../includes.h"
+
+#define	KB_MIN_MS	250		// Dure minimale de mesure d'une routine, en ms.
+#define	KB_MIX_LEN	(2048 * 2 * sizeof(s16))	// Buffer du mixer : 2048 samples stro 16 bits (cf. Sfx_SoundInit).
+#define	KB_PSD_FILENAME	"gfx/bkg1.psd"
+#define	KB_GIF_FILENAME	"gfx/ms0.gif"
+
+// Routines et variables sans prototype dans les .h.
+struct SSprStockage;
+extern struct SSprStockage	*gpSprSto;
+extern u32	gnSprSto;
+void SprDisplayLock(struct SSprStockage *pSprSto);
+void SprZoom_Render(void);
+void SprRotoZoom_Render(void);
+void Scr_sub_NewCol(u32 nPlane, s32 sBlMapX, s32 sBlMapY);
+void Scr_sub_NewLn(u32 nPlane, s32 sBlMapX, s32 sBlMapY);
+void Sfx_MixAudio(void *unused, u8 *stream, int len);
+void Render_InitVideo(void);
+void RenderRelease(void);
+void SpritesLoad(void);
+void GameInitLevel(void);
+s32 Level_RealNumber(u32 nLevelNo);
+
+// Une routine  mesurer : nOps appels, renvoie le temps pass en ticks du compteur haute rsolution.
+typedef Uint64 (*pKbFct)(u32 nOps);
+
+struct SKBench
+{
+	Uint64	nFreq;
+	u32	nMinMs;
+	char	*pFilter;
+	u32	nLevel;			// Offset dans gMissionTb,  partir de MISSIONOFFS_LEVELS.
+	u32	nSprNo;
+	// Paramtres de la routine en cours.
+	u32	nPrm;
+	s32	nPosX, nPosY;
+	upix	*pSrc;			// Scalers : Ecran synthtique.
+	u8	*pDst;				// Scalers : Destination.
+	struct SGIFFile	*pGif;
+};
+struct SKBench	gKb;
+
+//=============================================================================
+
+// Mesure d'une routine : On double le nb d'appels jusqu' dpasser la dure minimale.
+// nBytes : Octets produits par appel (0 = pas de dbit).
+void KB_sub_Run(char *pName, pKbFct pFct, u32 nBytes)
+{
+	Uint64	nTicks, nMin;
+	u32	nOps;
+	double	fNs;
+
+	if (gKb.pFilter != NULL && strstr(pName, gKb.pFilter) == NULL) return;
+
+	pFct(1);	// Chauffe (caches, pr-rendus).
+	nMin = (gKb.nFreq * gKb.nMinMs) / 1000;
+	for (nOps = 1; ; nOps *= 2)
+	{
+		nTicks = pFct(nOps);
+		if (nTicks >= nMin || nOps >= (1 << 30)) break;
+	}
+
+	fNs = ((double)nTicks * 1e9) / ((double)gKb.nFreq * nOps);
+	printf("%-36s %14.1f ns/op", pName, fNs);
+	if (nBytes) printf(" %12.1f MB/s", ((double)nBytes * 1e3) / fNs);
+	printf("\n");
+}
+
+//=============================================================================
+
+// Sprite normal, flipp, hit pal, clipp (n + flags dans nPrm, ref  l'cran en nPosX/nPosY).
+Uint64 KB_sub_SprDisplay(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+
+	gnSprSto = 0;
+	SprDisplayAbsolute(gKb.nPrm, gKb.nPosX, gKb.nPosY, 0);
+	RCtx_FrameBegin();
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++) SprDisplayLock(gpSprSto);
+	nTicks = SDL_GetPerformanceCounter() - nTicks;
+	RCtx_FrameEnd();
+	gnSprSto = 0;
+	return (nTicks);
+}
+
+// Rendu des zooms (nPrm = 0) et des rotozooms (nPrm = 1), dans le buffer 8 bits.
+Uint64 KB_sub_SprRZ(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+	void	*pFct;
+
+	if (gKb.nPrm)
+		SprRotoZoom_PreRender(gKb.nSprNo, 0x100, 32, &pFct);
+	else
+		SprZoom_PreRender(gKb.nSprNo, 0x180, 0x180, &pFct);
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++) ((pRZFctRender)pFct)();
+	return (SDL_GetPerformanceCounter() - nTicks);
+}
+
+// Nouvelle colonne de blocs dans le buffer de scroll du plan nPrm.
+Uint64 KB_sub_ScrNewCol(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i, nX;
+
+	RCtx_FrameBegin();
+	nX = 0;
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++)
+	{
+		Scr_sub_NewCol(gKb.nPrm, nX, 0);
+		if (++nX >= gMap.pPlanesLg[gKb.nPrm]) nX = 0;
+	}
+	nTicks = SDL_GetPerformanceCounter() - nTicks;
+	RCtx_FrameEnd();
+	return (nTicks);
+}
+
+// Nouvelle ligne de blocs dans le buffer de scroll du plan nPrm.
+Uint64 KB_sub_ScrNewLn(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i, nY;
+
+	RCtx_FrameBegin();
+	nY = 0;
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++)
+	{
+		Scr_sub_NewLn(gKb.nPrm, 0, nY);
+		if (++nY >= gMap.pPlanesHt[gKb.nPrm]) nY = 0;
+	}
+	nTicks = SDL_GetPerformanceCounter() - nTicks;
+	RCtx_FrameEnd();
+	return (nTicks);
+}
+
+// Affichage du plan de scroll nPrm.
+Uint64 KB_sub_ScrDisplay(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+
+	RCtx_FrameBegin();
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++) ScrollDisplayPlane(gKb.nPrm);
+	nTicks = SDL_GetPerformanceCounter() - nTicks;
+	RCtx_FrameEnd();
+	return (nTicks);
+}
+
+// Scaler : Facteur dans les bits 0-7 de nPrm, lignes TV bit 8, octets par pixel de la destination bits 16-23.
+Uint64 KB_sub_Scaler(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+	u32	nFactor = gKb.nPrm & 0xFF;
+	u32	nDstBpp = (gKb.nPrm >> 16) & 0xFF;
+
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++)
+		ScalerRenderBuf(gKb.pSrc, SCR_Width * sizeof(upix), SCR_Width, SCR_Height,
+			gKb.pDst, SCR_Width * nFactor * nDstBpp, nDstBpp, nFactor, (gKb.nPrm >> 8) & 1);
+	return (SDL_GetPerformanceCounter() - nTicks);
+}
+
+// Mixer : Un buffer SDL complet, 4 canaux de sfx actifs (+ musique si lance).
+Uint64 KB_sub_Mix(u32 nOps)
+{
+	static	u8	pStream[KB_MIX_LEN];
+	Uint64	nTicks, nStart;
+	u32	i;
+
+	nTicks = 0;
+	for (i = 0; i < nOps; i++)
+	{
+		// Redmarre les sfx (mme wav = mme canal), hors mesure.
+		Sfx_PlaySfx(e_Sfx_Fx_Explosion2, 1);
+		Sfx_PlaySfx(e_Sfx_Fx_WaterSplash, 1);
+		Sfx_PlaySfx(e_Sfx_Fx_GunReload, 1);
+		Sfx_PlaySfx(e_Sfx_Fx_Swoosh, 1);
+		nStart = SDL_GetPerformanceCounter();
+		Sfx_MixAudio(NULL, pStream, KB_MIX_LEN);
+		nTicks += SDL_GetPerformanceCounter() - nStart;
+	}
+	return (nTicks);
+}
+
+// Dcodage de l'image suivante du GIF anim.
+Uint64 KB_sub_Gif(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++) GIF_GetNextImage(gKb.pGif);
+	return (SDL_GetPerformanceCounter() - nTicks);
+}
+
+// Lecture d'un PSD (fichier + dpack RLE).
+Uint64 KB_sub_Psd(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+	struct SPSDPicture	*pPic;
+
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++)
+	{
+		if ((pPic = PSDLoad(KB_PSD_FILENAME)) == NULL) exit(1);
+		free(pPic->pPlanes);
+		free(pPic);
+	}
+	return (SDL_GetPerformanceCounter() - nTicks);
+}
+
+// Lecture complte d'un niveau.
+Uint64 KB_sub_LevelLoad(u32 nOps)
+{
+	Uint64	nTicks;
+	u32	i;
+
+	nTicks = SDL_GetPerformanceCounter();
+	for (i = 0; i < nOps; i++)
+	{
+		LevelLoad(gKb.nPrm);
+		LevelRelease();
+	}
+	return (SDL_GetPerformanceCounter() - nTicks);
+}
+
+//=============================================================================
+
+// Sprites.
+void KB_sub_Sprites(void)
+{
+	struct SSprite	*pSpr;
+	s32	nRefX, nRefY;
+
+	if ((pSpr = SprGetDesc(gKb.nSprNo)) == NULL) return;
+	printf("Sprite %d: %dx%d.\n", (int)gKb.nSprNo, (int)pSpr->nLg, (int)pSpr->nHt);
+	nRefX = pSpr->nPtRefX;
+	nRefY = pSpr->nPtRefY;
+
+	gKb.nPrm = gKb.nSprNo;
+	gKb.nPosX = nRefX + 8;
+	gKb.nPosY = nRefY + 8;
+	KB_sub_Run("SprDisplayLock normal", KB_sub_SprDisplay, pSpr->nLg * pSpr->nHt * sizeof(upix));
+	gKb.nPrm = gKb.nSprNo | SPR_Flip_X;
+	gKb.nPosX = (pSpr->nLg - 1 - nRefX) + 8;
+	KB_sub_Run("SprDisplayLock flip x", KB_sub_SprDisplay, pSpr->nLg * pSpr->nHt * sizeof(upix));
+	gKb.nPrm = gKb.nSprNo | SPR_Flag_HitPal;
+	gKb.nPosX = nRefX + 8;
+	KB_sub_Run("SprDisplayLock hit pal", KB_sub_SprDisplay, pSpr->nLg * pSpr->nHt * sizeof(upix));
+	// Clipp : La moiti gauche hors cran.
+	gKb.nPrm = gKb.nSprNo;
+	gKb.nPosX = nRefX - (pSpr->nLg / 2);
+	KB_sub_Run("SprDisplayLock clipped", KB_sub_SprDisplay, (pSpr->nLg - (pSpr->nLg / 2)) * pSpr->nHt * sizeof(upix));
+
+	// Zoom et rotozoom (taille du rsultat : cf. descripteur renvoy par le pr-rendu).
+	void	*pFct;
+	if ((pSpr = SprZoom_PreRender(gKb.nSprNo, 0x180, 0x180, &pFct)) != NULL)
+	{
+		gKb.nPrm = 0;
+		KB_sub_Run("SprZoom_Render x1.5", KB_sub_SprRZ, pSpr->nLg * pSpr->nHt);
+	}
+	if ((pSpr = SprRotoZoom_PreRender(gKb.nSprNo, 0x100, 32, &pFct)) != NULL)
+	{
+		gKb.nPrm = 1;
+		KB_sub_Run("SprRotoZoom_Render 45 deg", KB_sub_SprRZ, pSpr->nLg * pSpr->nHt);
+	}
+}
+
+// Scroll : Sur le niveau charg.
+void KB_sub_Scroll(void)
+{
+	u32	i, nHt, nLg;
+	char	pName[64];
+
+	for (i = 0; i < gMap.nPlanesNb; i++)
+	{
+		gKb.nPrm = i;
+		nHt = MIN((SCR_Height / 16) + 1, gMap.pPlanesHt[i]);
+		nLg = MIN((SCR_Width / 16) + 1, gMap.pPlanesLg[i]);
+		sprintf(pName, "Scr_sub_NewCol plane %d", (int)i);
+		KB_sub_Run(pName, KB_sub_ScrNewCol, nHt * 16 * 16 * sizeof(upix));
+		sprintf(pName, "Scr_sub_NewLn plane %d", (int)i);
+		KB_sub_Run(pName, KB_sub_ScrNewLn, nLg * 16 * 16 * sizeof(upix));
+		sprintf(pName, "ScrollDisplayPlane %d", (int)i);
+		KB_sub_Run(pName, KB_sub_ScrDisplay, SCR_Width * SCR_Height * sizeof(upix));
+	}
+}
+
+// Scalers : Ecran synthtique (bruit), destination en mmoire.
+void KB_sub_Scalers(void)
+{
+	static	u32	pnModes[] = { 2 | (4 << 16), 2 | 0x100 | (4 << 16), 3 | (4 << 16), 4 | (4 << 16), 2 | (2 << 16) };
+	static	char	*pNames[] = { "ScalerRenderBuf x2 32b", "ScalerRenderBuf TV x2 32b", "ScalerRenderBuf x3 32b", "ScalerRenderBuf x4 32b", "ScalerRenderBuf x2 16b" };
+	u32	i, nFactor;
+
+	gKb.pSrc = (upix *)malloc(SCR_Width * SCR_Height * sizeof(upix));
+	gKb.pDst = (u8 *)malloc(SCR_Width * SCR_Height * SCALER_FACTOR_MAX * SCALER_FACTOR_MAX * 4);
+	if (gKb.pSrc == NULL || gKb.pDst == NULL)
+	{
+		fprintf(stderr, "KB_sub_Scalers(): malloc failed.\n");
+		exit(1);
+	}
+	for (i = 0; i < SCR_Width * SCR_Height; i++) gKb.pSrc[i] = (upix)Rnd();
+
+	for (i = 0; i < NBELEM(pnModes); i++)
+	{
+		gKb.nPrm = pnModes[i];
+		nFactor = pnModes[i] & 0xFF;
+		KB_sub_Run(pNames[i], KB_sub_Scaler, SCR_Width * nFactor * SCR_Height * nFactor * ((pnModes[i] >> 16) & 0xFF));
+	}
+
+	free(gKb.pSrc);
+	free(gKb.pDst);
+}
+
+// Mixer.
+void KB_sub_Mixer(void)
+{
+	// Pas de priphrique audio => Pas d'init du son, pas de mesure.
+	Music_Start(e_YmMusic_Mission1, 1);
+	if (Music_GetMusicNo() != e_YmMusic_Mission1)
+	{
+		printf("No audio device, Sfx_MixAudio skipped.\n");
+		return;
+	}
+	KB_sub_Run("Sfx_MixAudio 4 sfx + music", KB_sub_Mix, KB_MIX_LEN);
+	Music_Start(e_YmMusic_NoMusic, 1);
+	KB_sub_Run("Sfx_MixAudio 4 sfx", KB_sub_Mix, KB_MIX_LEN);
+	Sfx_ClearChannels();
+}
+
+//=============================================================================
+
+int main(int argc, char *argv[])
+{
+	u32	i;
+
+	gKb.nMinMs = KB_MIN_MS;
+	gKb.pFilter = NULL;
+	gKb.nLevel = 0;
+	gKb.nSprNo = e_Spr_BigAsteroid;
+	for (i = 1; i < (u32)argc; i++)
+	{
+		if (strcmp(argv[i], "-ms") == 0 && i + 1 < (u32)argc) gKb.nMinMs = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-only") == 0 && i + 1 < (u32)argc) gKb.pFilter = argv[++i];
+		else if (strcmp(argv[i], "-level") == 0 && i + 1 < (u32)argc) gKb.nLevel = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-spr") == 0 && i + 1 < (u32)argc) gKb.nSprNo = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Usage: %s [-ms <n>] [-only <name>] [-level <n>] [-spr <n>]\n", argv[0]);
+			exit(1);
+		}
+	}
+	if (Level_RealNumber(MISSIONOFFS_LEVELS + gKb.nLevel) <= 0)
+	{
+		fprintf(stderr, "Wrong level number (%d).\n", (int)gKb.nLevel);
+		exit(1);
+	}
+
+	// Init, comme le jeu mais sans fentre visible.
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
+	{
+		fprintf(stderr, "Unable to init SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+	gKb.nFreq = SDL_GetPerformanceFrequency();
+	RndSeed(1);
+
+	Render_InitVideo();
+	RCtxInit();
+	ScrollAllocate();
+	PrecaSinCos();
+	SpritesLoad();
+	Sfx_SoundInit();	// Le son n'est pas lanc : Le mixer n'est appel que par le bench.
+	Sfx_LoadWavFiles();
+	Sfx_LoadYMFiles();
+	if ((gKb.pGif = GIF_Load(KB_GIF_FILENAME)) == NULL)
+	{
+		fprintf(stderr, "main(): GIF_Load() returned NULL.\n");
+		exit(1);
+	}
+	gnFrameMissed = 0;
+
+	printf("Minimum time per kernel: %d ms. upix = %d bits.\n", (int)gKb.nMinMs, (int)FB_BPP);
+
+	// Sprites, scalers, mixer.
+	KB_sub_Sprites();
+	KB_sub_Scalers();
+	KB_sub_Mixer();
+
+	// Dcodeurs.
+	KB_sub_Run("GIF_GetNextImage", KB_sub_Gif, gKb.pGif->pLogicalScrDesc->nLogScrWidth * gKb.pGif->pLogicalScrDesc->nLogScrHeight);
+	{
+		struct SPSDPicture	*pPic;
+		if ((pPic = PSDLoad(KB_PSD_FILENAME)) == NULL) exit(1);
+		KB_sub_Run("PSDLoad " KB_PSD_FILENAME, KB_sub_Psd, pPic->nWidth * pPic->nHeight * pPic->nNbPlanes);
+		free(pPic->pPlanes);
+		free(pPic);
+	}
+
+	// Niveau : Lecture, puis init comme en dbut de partie (ShootGame, e_Game_LoadLevel) pour le scroll.
+	ExgPlatformerInit(0, MISSIONOFFS_LEVELS + gKb.nLevel);
+	LevelLoad(gGameVar.nLevel);
+	{
+		u32	nSz = 0;
+		for (i = 0; i < gMap.nPlanesNb; i++) nSz += gMap.pBlkGfxNb[i] * BLK_TILE_PIX * sizeof(upix);
+		LevelRelease();
+		printf("Level %d (lev%d).\n", (int)gKb.nLevel, (int)gGameVar.nLevel);
+		gKb.nPrm = gGameVar.nLevel;
+		KB_sub_Run("LevelLoad", KB_sub_LevelLoad, nSz);
+	}
+	LevelLoad(gGameVar.nLevel);
+	AnmBlkInit(gGameVar.nLevel);
+	GameInitLevel();
+	KB_sub_Scroll();
+	LevelRelease();
+
+	GIF_Free(gKb.pGif);
+	Sfx_SoundOff();
+	Sfx_FreeWavFiles();
+	Sfx_FreeYMFiles();
+	SprRelease();
+	ScrollRelease();
+	RenderRelease();
+
+	return (0);
+}
+
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Corpus du benchmark : Regenere les enregistrements de bench/corpus.txt avec le bot (-botrecord, cf. replay.c).
+# Usage : bench/mkcorpus.sh <exe> [nom...]  (a lancer depuis minislug0, pour les gfx). Sans nom, tout le corpus.
+# Chaque enregistrement part du debut d'une mission (level selecteur) et s'arrete a la fin de la mission ou au nb de frames.
+# Les enregistrements contiennent les controles de desynchro et d'image : A refaire si le rendu ou la logique changent.
+
+EXE=${1:-./minislug}
+[ $# -gt 0 ] && shift
+DIR=bench
+
+# Nom, mission (index du level selecteur), nb max de frames (70 par seconde).
+CORPUS="
+lev1 0 3600
+lev13 1 3600
+lev7 2 3600
+lev15 3 3600
+lev5 4 3600
+lev6 5 3600
+lev16 6 3600
+lev2 7 3600
+lev8 8 3600
+lev9 9 3600
+lev11 10 3600
+lev14 11 3600
+lev17 12 3600
+boss 1 9000
+"
+
+echo "$CORPUS" | while read NAME MISSION FRAMES; do
+	[ -z "$NAME" ] && continue
+	if [ $# -gt 0 ] && ! echo " $* " | grep -q " $NAME "; then continue; fi
+	if ! $EXE -headless -botrecord $DIR/$NAME.rep $MISSION $FRAMES | grep "^Replay:" ||
+		! $EXE -headless -replay $DIR/$NAME.rep > /dev/null; then
+		echo "mkcorpus: $NAME failed."
+		exit 1
+	fi
+done
@@ -155,7 +155,7 @@ void AnmBlkBlocksTag(struct SBlkAnmStockage *pAnm, u32 nAnmNo)
 
 	pBlkPlane = gMap.ppPlanesBlocks[pAnm->nPlane];
 	pAnmPlane = gMap.ppBlkAnmPlanes[pAnm->nPlane];
-	nGfxPlaneLg = gMap.ppPlanesGfx[pAnm->nPlane]->w / 16;
+	nGfxPlaneLg = gMap.pBlkGfxLg[pAnm->nPlane];
 //todo: voir pour optimiser sur les tailles des plans, pas de la map.
 	for (bj = 0; bj < gMap.nMapHt; bj++)
 	for (bi = 0; bi < gMap.nMapLg; bi++)
@@ -303,3 +303,9 @@ void AnmBlkScrollNewLn(u32 nPlane, u32 nPosX, u32 nPosY)
 	}
 }
 
+// Snapshots : Etat des anims de blocs.
+void AnmBlkSnapZones(void)
+{
+	SnapZoneAdd(&gAnmBlk, sizeof(gAnmBlk), NULL, NULL);
+}
+
@@ -5,4 +5,5 @@ void AnmBlkManage(void);
 
 void AnmBlkScrollNewLn(u32 nPlane, u32 nPosX, u32 nPosY);
 void AnmBlkScrollNewCol(u32 nPlane, u32 nPosX, u32 nPosY);
+void AnmBlkSnapZones(void);
 
@@ -25,13 +25,13 @@ void BlkBkg(u32 nPlane, u32 nMapPosX, u32 nMapPosY, u32 nBlkLg, u32 nBlkHt, u32
 
 	//
 	pBlk = gMap.ppPlanesBlocks[nPlane];
-	nBlkMax = ((gMap.ppPlanesGfx[nPlane])->w / 16) * ((gMap.ppPlanesGfx[nPlane])->h / 16);
+	nBlkMax = gMap.pBlkGfxNb[nPlane];
 
 	for (iy = 0; (iy < nBlkHt) && (nMapPosY + iy < gMap.pPlanesHt[nPlane]); iy++)
 	for (ix = 0; (ix < nBlkLg) && (nMapPosX + ix < gMap.pPlanesLg[nPlane]); ix++)
 	{
 		// MAJ du n de bloc dans la map.
-		nBlkNo = nBlkOrg + (iy * ((gMap.ppPlanesGfx[nPlane])->w / 16)) + ix;
+		nBlkNo = nBlkOrg + (iy * gMap.pBlkGfxLg[nPlane]) + ix;
 		if (nBlkNo >= nBlkMax) nBlkNo = 0;
 		pBlk[((nMapPosY + iy) * gMap.nMapLg) + (nMapPosX + ix)] = nBlkNo;
 
@@ -199,7 +199,7 @@ void Mst20_CannonUp_Manage(struct SMstCommon *pMst, u16 nPrio)
 			AnmSet(gAnm_Boss1_CannonUp_Shot, pCannonUp->nAnm);
 			pCannonUp->nShotCnt = pCntTb[pSpe->nDecayState];
 			pCannonUp->nShotNo = 0;
-			pCannonUp->nShotHole = rand() % 7;		// Position du "trou".
+			pCannonUp->nShotHole = Rnd() % 7;		// Position du "trou".
 		}
 		break;
 
@@ -477,7 +477,7 @@ Special Init = 23:26: None - Truck Jump - SuspSub Jump - Hero Height -	; Inits s
 RESERVED2 = 27:31:
 */
 			static u8 pM14[] = { 3, 3, 0, 1 };	// Pour g�n�rer des soldats, sauf LRAC.
-			u32	nPrm = ((u32)pM14[rand() & 3]) | (1 * 4096) | (2 << 15);	// 0 = Rifle - 1 = Mortar / 1 * 4096 = Move / 2 << 15 = Jump always.
+			u32	nPrm = ((u32)pM14[Rnd() & 3]) | (1 * 4096) | (2 << 15);	// 0 = Rifle - 1 = Mortar / 1 * 4096 = Move / 2 << 15 = Jump always.
 			if (((++nSide) & 1) == 0)
 			{
 				// Arriv�e par la porte � droite.
@@ -500,7 +500,7 @@ RESERVED2 = 27:31:
 				nPrm |= 2;	// Type = LRAC.
 				nPrm |= 8 * 256;		// Offset, pour que le parachute arrive au bon endroit. (Pour le parachutiste, on se sert de ce d�calagae comme offset dans l'�cran, voir init).
 				nPrm |= 1 << 14;	// Parachute.
-				MstAdd(e_Mst14_RebelSoldier0, ((224 + (rand() & 7))*16), (0*16), (u8 *)&nPrm, -1);
+				MstAdd(e_Mst14_RebelSoldier0, ((224 + (Rnd() & 7))*16), (0*16), (u8 *)&nPrm, -1);
 			}
 //< tst parachutiste
 
@@ -749,7 +749,7 @@ void Boss_Explosions(u8 *pnExplo, s32 nPosX, s32 nPosY, s32 nWidth2n, s32 nHeigh
 
 //Sfx_PlaySfx(e_Sfx_Fx_Explosion2, e_SfxPrio_Explosion);
 
-		i = rand();
+		i = Rnd();
 		DustSet(gAnm_Explosion0_Medium_Dust,	//gAnm_Explosion0_Medium_NoSfx_Dust,	//gAnm_Explosion0_Medium_Dust,
 			nPosX + ((i & nWidth2n) * 256),
 			nPosY + ((i & nHeight2n) * 256),
@@ -1376,7 +1376,7 @@ if (gVar.pKeys[SDL_SCANCODE_J])
 		// L�cher de mini bombes.
 		pSpe->nFrmCnt++;
 		if ((pSpe->nFrmCnt & 7) == 0 && (pSpe->nFrmCnt & 64))
-			FireAdd(e_Shot_Enemy_HairBusterRibert_Mine, pMst->nPosX - (56 * 256), pMst->nPosY - (28 * 256), 0 + (rand() & 15) + (pSpe->nSensY ? -15 : 0));
+			FireAdd(e_Shot_Enemy_HairBusterRibert_Mine, pMst->nPosX - (56 * 256), pMst->nPosY - (28 * 256), 0 + (Rnd() & 15) + (pSpe->nSensY ? -15 : 0));
 
 		nMaskDisp = 1;	// On demande l'affichage du cache.
 		break;
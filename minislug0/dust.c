@@ -226,6 +226,11 @@ Font_Print(10, 100, pScore, 0);
 
 }
 
-
-
+// Snapshots : Slots des poussires.
+void DustSnapZones(void)
+{
+	SnapZoneAdd(gpDustSlots, sizeof(gpDustSlots), NULL, NULL);
+	SnapZoneAdd(&gnDustLastUsed, sizeof(gnDustLastUsed), NULL, NULL);
+	SnapZoneAdd(&gDustExg, sizeof(gDustExg), NULL, NULL);
+}
 
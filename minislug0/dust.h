@@ -25,4 +25,5 @@ void DustInitEngine(void);
 void DustManage(void);
 s32 DustSet(u64 *pAnm, s32 nPosX, s32 nPosY, u8 nPrio, u32 nFlags);
 s32 DustSetMvt(u64 *pAnm, s32 nPosX, s32 nPosY, s32 nSpdX, s32 nSpdY, u8 nPrio, u32 nFlags);
+void DustSnapZones(void);
 
@@ -543,19 +543,14 @@ _FireEnd2:
 
 }
 
-#ifdef DEBUG_DISP
-// debug.
-void shot_tst_dispnb(u32 nPosY)
+// Nb de slots utiliss (profiler).
+u32 FireSlotsUsedNb(void)
 {
 	u32	i, k;
-	// Compte.
+
 	for (i = 0, k = 0; i < FIRE_MAX_SLOTS; i++) if (gpFireSlots[i].nUsed) k++;
-	// Affichage.
-	char	pTb[4+8+1] = "SHT:00000000";
-	MyItoA(k, pTb);
-	Font_Print(10, nPosY, pTb, 0);
+	return (k);
 }
-#endif
 
 //=============================================================================
 
@@ -873,4 +868,12 @@ u8 ChaserTarget_AcquireTarget(struct SFire *pFire)
 	return (nAng);
 }
 
+// Snapshots : Tirs et cibles des missiles  tte chercheuse.
+void FireSnapZones(void)
+{
+	SnapZoneAdd(gpFireSlots, sizeof(gpFireSlots), NULL, NULL);
+	SnapZoneAdd(&gnFireLastUsed, sizeof(gnFireLastUsed), NULL, NULL);
+	SnapZoneAdd(gpChaserTargetSlots, sizeof(gpChaserTargetSlots), NULL, NULL);
+	SnapZoneAdd(&gnChaserTargetInList, sizeof(gnChaserTargetInList), NULL, NULL);
+}
 
@@ -78,6 +78,8 @@ void FireRemoveFromList(s32 nShotIdx);
 
 void ChaserTarget_ClearList(void);
 void ChaserTarget_AddToList(s32 nPosX, s32 nPosY);
+u32 FireSlotsUsedNb(void);
+void FireSnapZones(void);
 
 
 
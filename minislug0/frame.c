@@ -1,54 +1,114 @@
 
 #include "includes.h"
 
-#define FPS_Default (1000 / 70)
-u32 gnTimer1;
+// Cadencement des frames.
+// La logique tourne  exactement FPS_Default Hz : le temps coul (compteur haute rsolution) s'accumule, chaque frame
+// logique en consomme une priode. En retard, les frames suivantes sont calcules sans rendu (gnFrameMissed), en avance
+// on dort jusqu' l'chance (SDL_Delay pour le gros, puis quelques yields pour la fin).
+// L'accumulateur est en ticks * FPS_Default : une frame = nFreq, pas d'arrondi, pas de drive (1000/70 ms faisait 71.4 Hz).
+// Rendu : Une image par frame logique trace.
+// - Sans vsync, elle est prsente  l'chance de la frame.
+// - Avec vsync (cran plus rapide que la logique, cf. PresentInit), elle est prsente tout de suite, puis reprsente
+//  chaque rafrachissement jusqu' la frame logique suivante : l'cran est aliment  sa frquence (144 Hz...), la
+// logique reste  FPS_Default Hz. Pas d'interpolation : chaque image reste affiche 2 ou 3 rafrachissements.
+
+#define	FPS_MissMax	(2)		// Nb max de frames rattrapes sans rendu. Au del, le retard est abandonn.
+#define	FPS_VSyncFastMax	(8)	// Nb de prsentations conscutives sans attente avant d'abandonner la vsync (ignore par le driver).
+#ifdef __EMSCRIPTEN__
+#define	FPS_SpinMs	0		// Pas d'attente active, on rend la main au navigateur.
+#else
+#define	FPS_SpinMs	1		// Fin de l'attente en yields (SDL_Delay a une prcision de l'ordre de la ms).
+#endif
+
 u32 gnFrame;	// Compteur gnral.
-#define	FPS_MissMax	(2)
-u8	gnFrameMissed;
+u8	gnFrameMissed;	// Nb de frames logiques  rattraper : pas de rendu tant que != 0.
+struct SFramePacer	gFrame;
+
+// Accumule le temps coul depuis le dernier appel.
+void Frame_sub_Elapsed(void)
+{
+	Uint64	nNow;
+
+	nNow = SDL_GetPerformanceCounter();
+	gFrame.nAcc += (Sint64)(nNow - gFrame.nLast) * FPS_Default;
+	gFrame.nLast = nNow;
+}
+
+// Attente jusqu' l'chance de la frame (accumulateur revenu  0).
+// Vsync : Tant qu'il reste au moins un rafrachissement avant l'chance, on reprsente l'image (bloque jusqu'au suivant).
+void Frame_sub_Sleep(void)
+{
+	Sint64	nMs;
+	Uint64	nStart;
+
+	while (1)
+	{
+		Frame_sub_Elapsed();
+		if (gFrame.nAcc >= 0) break;
+		if (gPresent.nVSync && -gFrame.nAcc * gPresent.nRefresh >= gFrame.nFreq * FPS_Default)
+		{
+			nStart = SDL_GetPerformanceCounter();
+			PresentFlip();
+			gFrame.nRepeated++;
+			// Prsentation revenue avant un quart de rafrachissement ? Trop souvent => Pas de vsync, attente normale.
+			if ((Sint64)(SDL_GetPerformanceCounter() - nStart) * gPresent.nRefresh * 4 < gFrame.nFreq)
+			{
+				if (++gFrame.nVSyncFast >= FPS_VSyncFastMax) gPresent.nVSync = 0;
+			}
+			else
+				gFrame.nVSyncFast = 0;
+			continue;
+		}
+		nMs = (-gFrame.nAcc * 1000) / (gFrame.nFreq * FPS_Default);	// Temps restant, en ms.
+		SDL_Delay(nMs > FPS_SpinMs ? (u32)(nMs - FPS_SpinMs) : 0);
+	}
+}
 
 // Init timers.
 void FrameInit(void)
 {
-	gnTimer1 = SDL_GetTicks();
-	gnFrameMissed = 0;
+	gFrame.nFreq = SDL_GetPerformanceFrequency();
+	gFrame.nLast = SDL_GetPerformanceCounter();
+	gFrame.nAcc = 0;
+	gnFrameMissed = (gFrame.nUnthrottled ? gFrame.nNoRaster : 0);
 }
 
-// Attente de la frame.
+// Attente de la frame. A appeler une fois par frame logique, avec ou sans rendu.
 void FrameWait(void)
 {
-	u32	nTimer2;
+	Sint64	nMissed;
 
-/*
-*/
-	// On a loup des frames ?
-	if (gnFrameMissed == 0)
+	// Pas de cadencement (headless) : On enchane, pas d'attente ni de frames sautes.
+	if (gFrame.nUnthrottled)
 	{
-		nTimer2 = SDL_GetTicks() - gnTimer1;
-		if (nTimer2 >= FPS_Default) gnFrameMissed = nTimer2 / FPS_Default;
-//if (gnFrameMissed) printf("Frames missed: %d / %d\n", gnFrame, gnFrameMissed);
-		if (gnFrameMissed > FPS_MissMax) gnFrameMissed = FPS_MissMax;	// On ne saute pas trop de frames quand mme.
-		if (gnFrameMissed) goto _FrameEnd;
+		gnFrameMissed = gFrame.nNoRaster;
+		gnFrame++;
+		return;
+	}
+
+	Frame_sub_Elapsed();
+	gFrame.nAcc -= gFrame.nFreq;	// La frame logique qui vient d'tre calcule.
+
+	if (gFrame.nAcc >= gFrame.nFreq)
+	{
+		// On a loup des frames : les suivantes seront calcules sans rendu.
+		nMissed = gFrame.nAcc / gFrame.nFreq;
+		if (nMissed > FPS_MissMax)
+		{
+			// On ne saute pas trop de frames quand mme (chargement, fentre dplace...).
+			gFrame.nDropped += nMissed - FPS_MissMax;
+			gFrame.nAcc -= (nMissed - FPS_MissMax) * gFrame.nFreq;
+			nMissed = FPS_MissMax;
+		}
+		gnFrameMissed = nMissed;
+//printf("Frames missed: %d / %d\n", gnFrame, gnFrameMissed);
 	}
 	else
 	{
-		gnFrameMissed--;
-		goto _FrameEnd;
+		gnFrameMissed = 0;
+		if (gFrame.nAcc < 0) Frame_sub_Sleep();	// On s'assure qu'on ne va pas trop vite...
 	}
 
-//nTimer2 = SDL_GetTicks() - gnTimer1;
-//if (nTimer2 >= FPS_Default) printf("missed: %d\n", nTimer2 / FPS_Default);
-
-	// On s'assure qu'on ne va pas trop vite...
-	while (1)
-	{
-		nTimer2 = SDL_GetTicks() - gnTimer1;
-		if (nTimer2 >= FPS_Default) break;
-		SDL_Delay(3);
-	}
-_FrameEnd:
-	gnTimer1 = SDL_GetTicks();
-
 	gnFrame++;
 
 }
@@ -1,8 +1,24 @@
+
+#define	FPS_Default	70		// Frquence de la logique, en Hz.
+
+// Cadencement.
+struct SFramePacer
+{
+	Sint64	nFreq;		// Frquence du compteur haute rsolution (ticks par seconde).
+	Uint64	nLast;		// Compteur au dernier appel.
+	Sint64	nAcc;		// Temps accumul non consomm par la logique, en ticks * FPS_Default. 1 frame = nFreq.
+	u32	nDropped;		// Frames abandonnes (retard suprieur  FPS_MissMax).
+	u32	nRepeated;		// Vsync : Images reprsentes en attendant la frame logique suivante.
+	u8	nVSyncFast;		// Vsync : Prsentations conscutives revenues sans attendre le rafrachissement.
+	u8	nUnthrottled;	// 1 = Pas de cadencement, les frames s'enchanent (headless).
+	u8	nNoRaster;		// 1 = Toutes les frames sont calcules sans rendu (avec nUnthrottled).
+};
+extern struct SFramePacer	gFrame;
 
 extern	u32 gnFrame;
+extern	u8	gnFrameMissed;	// != 0 : Frame calcule sans rendu (retard), les modules de trac ne font rien.
 
 // Prototypes.
 void FrameInit(void);
 void FrameWait(void);
 
-
@@ -560,7 +560,7 @@ void ExgPlatformerInit(s32 nCreditsNb, u32 nMissionTbOffset)
 	gGameVar.nExitCode = 0;
 	gGameVar.nPhase = e_Game_LoadLevel;	// !!!
 
-	srand(time(NULL));		// Init hasard.
+	RndSeed(gReplay.nActive ? gReplay.sHdr.nSeed : (u32)time(NULL));		// Init hasard (graine du fichier en enregistrement/rejeu).
 
 
 	// Level sï¿½lecteur activï¿½ ? (et jeu ? i.e. pas crï¿½dits ou how to play).
@@ -2380,11 +2380,11 @@ void Player_ShotCheck(u32 nSpr, u32 nUp)
 			if (gShoot.nWeapon == e_Player_Weapon_Machinegun)
 			{
 				static	s8	gpShotAngRand[] = { 0, 1, 0, -1 };
-				nAddAng = gpShotAngRand[rand() & 3];
+				nAddAng = gpShotAngRand[Rnd() & 3];
 			}
 			else if (gShoot.nWeapon == e_Player_Weapon_Flamethrower)
 			{
-				nAddAng = (rand() & 15) - 7;
+				nAddAng = (Rnd() & 15) - 7;
 			}
 
 			if (nUp)
@@ -3743,7 +3743,7 @@ void PlayerControl_Naked(void)
 		// Toutes les 2 sec, un rnd.
 		if (++gShoot.nBoredCnt > 128)
 		{
-			u32	nRnd = rand();
+			u32	nRnd = Rnd();
 			if ((nRnd & 0xFF) < 0x40)
 			{
 				static u64 *pBoredAnm_Gun[e_Player_Weapon_Max][2] =
@@ -4087,6 +4087,7 @@ u32 ShootGame(void)
 			Transit2D_InitOpening(gMissionTb[gGameVar.nGenLevel].nVehicleType == e_HeroVehicle_Rocket ? e_Transit_InterLvl_V : e_Transit_InterLvl_H);	// Ouverture inter level.
 			Player_LvlDataRestore();	// Restore les variables du joueur.
 		}
+		SnapLevelStart();		// Snapshots : Zones du niveau.
 		break;
 
 	case e_Game_MissionStart:	// "Mission x Start".
@@ -4393,6 +4394,7 @@ void PlatformerGame(void)
 	u32	i;
 
 	if (ShootGame()) return;		// !!! Ne pas dï¿½placer !!! (Load level fait dedans !).
+	SnapKeys();		// Sauvegarde / chargement / rembobinage.
 
 	// Deux direction opposï¿½es ï¿½ la fois ? => Clear.
 //	if (gVar.pKeys[SDL_SCANCODE_UP] && gVar.pKeys[SDL_SCANCODE_DOWN]) gVar.pKeys[SDL_SCANCODE_UP] = gVar.pKeys[SDL_SCANCODE_DOWN] = 0;
@@ -4401,20 +4403,32 @@ void PlatformerGame(void)
 	if (gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Left]] && gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Right]]) gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Left]] = gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Right]] = 0;
 
 	// Contrï¿½le du joueur.
+	PROF_START(e_Prof_Plyr);
 	gpFctCtrlTb[gShoot.nVehicleType]();
+	PROF_STOP(e_Prof_Plyr);
 
+	PROF_START(e_Prof_Scroll);
 	ScrollManage();
+	PROF_STOP(e_Prof_Scroll);
+	PROF_START(e_Prof_BlkAnm);
 	AnmBlkManage();
+	PROF_STOP(e_Prof_BlkAnm);
 
+	PROF_START(e_Prof_Fire);
 	FireManage();
 	FireDestructibleCheck();
 	ChaserTarget_ClearList();		// Cleare les cibles des homing missiles.
+	PROF_STOP(e_Prof_Fire);
+	PROF_START(e_Prof_Mst);
 	MstManage();
+	PROF_STOP(e_Prof_Mst);
 
 	Inactivity();
 
 	// Affichage du joueur.
+	PROF_START(e_Prof_Plyr);
 	gpFctDispTb[gShoot.nVehicleType]();		// APRES les monstres, car les pf mobiles peuvent dï¿½placer le joueur.
+	PROF_STOP(e_Prof_Plyr);
 	Gen_KbRestore();	// Aprï¿½s la gestion et l'affichage, on restore systï¿½matiquement le clavier ! Il sera cleanï¿½ ï¿½ nouveau dans les cas spï¿½ciaux.
 	// Traitement des variables spï¿½ciales.
 	gShoot.nMstProximity = 0;				// RAZ du flag de proximitï¿½.
@@ -4438,21 +4452,45 @@ void PlatformerGame(void)
 
 	CheckSpecialScore();	// +1 vie tous les x points.
 
+	PROF_START(e_Prof_Dust);
 	DustManage();
+	PROF_STOP(e_Prof_Dust);
 
+	PROF_START(e_Prof_HUD);
 	if (gMissionTb[gGameVar.nGenLevel].nMissionNo != 0)	// Mission nï¿½ == 0 => Cas spï¿½ciaux du how to play et des crï¿½dits. Pas de HUD.
 		HUDDisplay();	// Affichage du HUD.
+	PROF_STOP(e_Prof_HUD);
+	ProfOverlayPrint();		// Profiler : p50/p99 et compteurs (F11).
 
 	// Affichage du dï¿½cor, plans derriï¿½re des sprites.
+	PROF_START(e_Prof_ScrDisp);
 	for (i = 0; i <= gMap.nHeroPlane; i++) ScrollDisplayPlane(i);
+	PROF_STOP(e_Prof_ScrDisp);
 	// Les sprites sous l'avant plan (quasiment tout).
+	PROF_START(e_Prof_Spr);
 	SprDisplayAll_Pass1();
+	PROF_STOP(e_Prof_Spr);
 	// Affichage du dï¿½cor, plans devant les sprites.
+	PROF_START(e_Prof_ScrDisp);
 	for (i = gMap.nHeroPlane + 1; i < gMap.nPlanesNb; i++) ScrollDisplayPlane(i);
+	PROF_STOP(e_Prof_ScrDisp);
 	// Les sprites au dessus de l'avant-plan (hud, ...).
+	PROF_START(e_Prof_Spr);
 	SprDisplayAll_Pass2();
+	PROF_STOP(e_Prof_Spr);
 
-}
+	PROF_START(e_Prof_Snap);
+	SnapFrame();	// Capture pour le rembobinage.
+	PROF_STOP(e_Prof_Snap);
 
+}
 
+// Snapshots : Variables de la partie et du joueur.
+void GameSnapZones(void)
+{
+	SnapZoneAdd(&gGameVar, sizeof(gGameVar), NULL, NULL);
+	SnapZoneAdd(&gShoot, sizeof(gShoot), NULL, NULL);
+	SnapZoneAdd(&gShootSav, sizeof(gShootSav), NULL, NULL);
+	SnapZoneAdd(&gInactivityWrt, sizeof(gInactivityWrt), NULL, NULL);
+}
 
@@ -182,6 +182,7 @@ enum
 
 void ExgPlatformerInit(s32 nCreditsNb, u32 nMissionTbOffset);
 void PlatformerGame(void);
+void GameSnapZones(void);
 
 void Player_Control(void);
 void Player_WeaponSet(u32 nWeaponNo);
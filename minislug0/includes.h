@@ -9,6 +9,25 @@
 
 #include "ctypes.h"
 
+// Format des buffers internes : cran du jeu, buffers de scroll, gfx des plans, palettes et sprites.
+#ifndef FB32_ON
+#define	FB32_ON	0	// 1 = 32 bits XRGB8888 (format natif des crans actuels) / 0 = 16 bits 565. (make CFLAGS+=-DFB32_ON=1).
+#endif
+
+#if FB32_ON == 1
+typedef u32	upix;
+#define	FB_BPP		32
+#define	FB_RMASK	0x00FF0000
+#define	FB_GMASK	0x0000FF00
+#define	FB_BMASK	0x000000FF
+#else
+typedef u16	upix;
+#define	FB_BPP		16
+#define	FB_RMASK	0xF800
+#define	FB_GMASK	0x07E0
+#define	FB_BMASK	0x001F
+#endif
+
 #define	MAP_PLANES_MAX	4//3//2//1
 #define LEVEL_MAX	18	// (0  17)
 
@@ -20,8 +39,14 @@
 #include "loader.h"
 #include "scroll.h"
 #include "frame.h"
+#include "prof.h"
+#include "rctx.h"
+#include "scaler.h"
+#include "present.h"
 #include "sprcache.h"
 #include "sprites.h"
+#include "sprspan.h"
+#include "sprsimd.h"
 #include "sprrz.h"
 #include "animspr.h"
 #include "anims.h"
@@ -40,6 +65,8 @@
 #include "transit2d.h"
 #include "interface.h"
 #include "roguelike.h"
+#include "replay.h"
+#include "snap.h"
 
 //=====================================
 
@@ -127,10 +154,12 @@ extern struct SCheatCodes	gCCodes;
 
 #define RENDER_BPP 1
 struct SRender {
-    SDL_Surface *pScreen2x;
     SDL_Surface *pScreenBuf2;
     u8 nRenderMode;
     u8 nFullscreenMode;
+    u8 nPresent;        // Backend de prsentation (e_Present_...).
+    u8 nNoPresent;      // 1 = Pas de scaling ni de prsentation (headless).
+    u8 nNoVSync;        // 1 = Pas de vsync, mme sur un cran plus rapide que la logique.
 #ifdef RENDER_BPP
     u8 nRenderBPP;
 #endif
@@ -5,9 +5,6 @@
 // HUD.
 
 #ifdef DEBUG_DISP
-extern void anm_tst_dispnb(u32 nPosY);
-extern void mst_tst_dispnb(u32 nPosY);
-extern void shot_tst_dispnb(u32 nPosY);
 extern void sfx_tst_dispnb(u32 nPosY);
 #endif
 
@@ -80,10 +77,8 @@ void HUDDisplay(void)
 		SprDisplayAbsolute(e_Spr_HUD_Prisoner, HUD_PRISONER_POSX + (i * 7), HUD_PRISONER_POSY, HUD_SPR_PRIO);
 
 
+	// Nb de mst, d'anims, de tirs, de sprites, stats du cache : cf. overlay du profiler (F11).
 #ifdef DEBUG_DISP
-//anm_tst_dispnb(64);		// nb d'anims.
-//mst_tst_dispnb(64+8);	// nb de monstres.
-//shot_tst_dispnb(64+16);	// nb de tirs.
 //sfx_tst_dispnb(64);
 #endif
 
@@ -466,3 +461,10 @@ u32 MSE_EndMissionStatusDisplay(void)
 	return (0);
 }
 
+// Snapshots : Affichages du dbut et de la fin de mission.
+void InterfaceSnapZones(void)
+{
+	SnapZoneAdd(&gMSE, sizeof(gMSE), NULL, NULL);
+	SnapZoneAdd(&gEMS, sizeof(gEMS), NULL, NULL);
+}
+
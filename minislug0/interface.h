@@ -12,4 +12,5 @@ void MSE_ContinueCountDown_Faster(void);
 
 void MSE_EndMissionStatusReset(void);
 u32 MSE_EndMissionStatusDisplay(void);
+void InterfaceSnapZones(void);
 
@@ -547,11 +547,65 @@ _err_exit1:
 
 //=============================================================================
 
+// Recopie les blocs des planches  la suite : le bloc n commence  n * BLK_TILE_PIX,
+// plus de division par la largeur de la planche  chaque copie dans le scroll.
+// Et opacit de chaque bloc, d'aprs la couleur transparente. Le plan 0 est trac sans transparence, tous ses blocs
+// sont opaques.
+// Les planches sont libres ensuite, on ne garde que leurs dimensions en blocs (pas de double des graphs en mmoire).
+void Map_sub_BlkTiles(void)
+{
+	SDL_Surface	*pGfx;
+	upix	*pSrc, *pDst;
+	u32	nPlane, nBlk, nBlkLg, nBlkNb;
+	u32	i, j, nKeyNb, nPitch;
+
+	for (nPlane = 0; nPlane < gMap.nPlanesNb; nPlane++)
+	{
+		pGfx = gMap.ppPlanesGfx[nPlane];
+		nPitch = pGfx->pitch / sizeof(upix);
+		nBlkLg = pGfx->w / 16;
+		nBlkNb = nBlkLg * (pGfx->h / 16);
+		gMap.ppBlkTiles[nPlane] = (upix *)malloc(nBlkNb * BLK_TILE_PIX * sizeof(upix));
+		gMap.ppBlkOpacity[nPlane] = (u8 *)malloc(nBlkNb);
+		if (gMap.ppBlkTiles[nPlane] == NULL || gMap.ppBlkOpacity[nPlane] == NULL)
+		{
+			fprintf(stderr, "LoadLevel(): malloc failed (gMap.ppBlkTiles[%d]).\n", (int)nPlane);
+			exit(1);
+		}
+		pDst = gMap.ppBlkTiles[nPlane];
+		for (nBlk = 0; nBlk < nBlkNb; nBlk++)
+		{
+			pSrc = (upix *)pGfx->pixels + ((nBlk / nBlkLg) * 16 * nPitch) + ((nBlk % nBlkLg) * 16);
+			nKeyNb = 0;
+			for (j = 0; j < 16; j++, pSrc += nPitch, pDst += 16)
+			{
+				memcpy(pDst, pSrc, 16 * sizeof(upix));
+				for (i = 0; i < 16; i++)
+					if (pSrc[i] == (upix)gMap.nTranspColorKey) nKeyNb++;
+			}
+			gMap.ppBlkOpacity[nPlane][nBlk] = (nKeyNb == 0 ? e_BlkOpa_Opaque : (nKeyNb == 16 * 16 ? e_BlkOpa_Empty : e_BlkOpa_Mixed));
+		}
+		if (nPlane == 0) memset(gMap.ppBlkOpacity[nPlane], e_BlkOpa_Opaque, nBlkNb);
+
+		gMap.pBlkGfxLg[nPlane] = nBlkLg;
+		gMap.pBlkGfxNb[nPlane] = nBlkNb;
+		SDL_FreeSurface(pGfx);
+		gMap.ppPlanesGfx[nPlane] = NULL;
+	}
+
+}
+
 // Libre les ressources utilises par le niveau en cours.
 void LevelRelease(void)
 {
 	u32	i;
 
+	SnapLevelEnd();		// Les zones des snapshots pointent dans les datas du niveau.
+
+	#if CACHE_ON == 1
+	CacheStatsLevelEnd();	// Stats du cache du niveau.
+	#endif
+
 	for (i = 0; i < gMap.nPlanesNb; i++)
 	{
 		SDL_FreeSurface(gMap.ppPlanesGfx[i]);
@@ -559,6 +613,10 @@ void LevelRelease(void)
 		*(gMap.ppPlanesBlocks + i) = NULL;
 
 		if (*(gMap.ppColCodes + i) != NULL) free(*(gMap.ppColCodes + i));
+		free(gMap.ppBlkTiles[i]);
+		gMap.ppBlkTiles[i] = NULL;
+		free(gMap.ppBlkOpacity[i]);
+		gMap.ppBlkOpacity[i] = NULL;
 	}
 	gMap.nPlanesNb = 0;
 
@@ -587,6 +645,23 @@ void LevelRelease(void)
 
 }
 
+// Snapshots : Datas du niveau modifies en cours de jeu (blocs, codes de collision, tat des monstres, sprites durs).
+void LevelSnapZones(void)
+{
+	u32	i;
+
+	for (i = 0; i < gMap.nPlanesNb; i++)
+	{
+		SnapZoneAdd(gMap.ppPlanesBlocks[i], gMap.nMapLg * gMap.nMapHt * sizeof(s32), NULL, NULL);
+		SnapZoneAdd(gMap.ppColCodes[i], gMap.pColCodesNb[i] * sizeof(struct SBlockCol), NULL, NULL);
+	}
+	SnapZoneAdd(gMap.pBlkAnmMem, gMap.nPlanesNb * gMap.nMapLg * gMap.nMapHt, NULL, NULL);
+	SnapZoneAdd(&gLoadedMst, sizeof(gLoadedMst), NULL, NULL);
+	SnapZoneAdd(gLoadedMst.pMstState, gLoadedMst.nMstNbInList, NULL, NULL);
+	SnapZoneAdd(gpHardSprSlots, sizeof(gpHardSprSlots), NULL, NULL);
+	SnapZoneAdd(&gnHardSprLastUsed, sizeof(gnHardSprLastUsed), NULL, NULL);
+}
+
 
 
 // La comparaison du qsort pour trier les monstres sur le X (puis sur le Y).
@@ -693,6 +768,10 @@ void LevelLoad(u32 nLevelNo)
 	char	pLevFilename[256];	// Nom du fichier, prcd du rpertoire.
 	char	pFilename[256];		// Noms de fichiers annexes  lire (planches...).
 
+	#if CACHE_ON == 1
+	CacheStatsLevelStart(nLevelNo);		// Stats du cache du niveau.
+	#endif
+
 
 	// RAZ monstres.
 	gLoadedMst.nMstNbInList = 0;
@@ -1081,6 +1160,7 @@ printf("Path: (%d, %d) Blk:%d.\n", (int)pPathBlk->nPosX, (int)pPathBlk->nPosY, (
 
 			// Une page de codes est prsente ?
 			*(gMap.ppColCodes + gMap.nPlanesNb) = NULL;
+			gMap.pColCodesNb[gMap.nPlanesNb] = 0;
 			if (((struct SPlane2 *)pBuf)->nFlags & e_FlgFile_Plane_Codes)
 			{
 #ifdef DEBUG_INFO
@@ -1103,6 +1183,7 @@ printf("Plane #%d, codes found.\n", (int)gMap.nPlanesNb);
 					exit(1);
 				}
 				memset(*(gMap.ppColCodes + gMap.nPlanesNb), 0, nPlaneSav_BlkLg * nPlaneSav_BlkHt * sizeof(struct SBlockCol));
+				gMap.pColCodesNb[gMap.nPlanesNb] = nPlaneSav_BlkLg * nPlaneSav_BlkHt;
 				// Copie.
 				//memcpy(*(gMap.ppColCodes + gMap.nPlanesNb), pCur, nPlaneSav_BlkLg * nPlaneSav_BlkHt * sizeof(u8));
 				for (j = 0; j < nPlaneSav_BlkLg * nPlaneSav_BlkHt; j++)
@@ -1525,6 +1606,9 @@ printf("Level loaded.\n");
 	memset(gMap.pBlkAnmMem, -1, gMap.nPlanesNb * gMap.nMapLg * gMap.nMapHt);	// Tout  0xFF.
 	for (j = 0; j < gMap.nPlanesNb; j++) gMap.ppBlkAnmPlanes[j] = gMap.pBlkAnmMem + (j * gMap.nMapLg * gMap.nMapHt);
 
+	// Blocs  la suite et opacit des blocs.
+	Map_sub_BlkTiles();
+
 }
 
 
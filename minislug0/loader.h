@@ -65,7 +65,7 @@ struct SMap
 	u32	nMapHt;
 	u32	nPlanesNb;
 
-	SDL_Surface	*ppPlanesGfx[MAP_PLANES_MAX];	// Graphs des plans.
+	SDL_Surface	*ppPlanesGfx[MAP_PLANES_MAX];	// Graphs des plans. Pendant le chargement seulement (recopis dans ppBlkTiles).
 	s32	*ppPlanesBlocks[MAP_PLANES_MAX];		// Les plans (n de blocs).
 	s32	pPlanesLg[MAP_PLANES_MAX];		// Largeur et hauteur de chaque plan en blocs 16, dans une surface de nMapLg * nMapHt.
 	s32	pPlanesHt[MAP_PLANES_MAX];
@@ -73,6 +73,7 @@ struct SMap
 
 	//u8	*ppColCodes[MAP_PLANES_MAX];	// Les codes de collision.
 	struct SBlockCol	*ppColCodes[MAP_PLANES_MAX];	// Les codes de collision.
+	u32	pColCodesNb[MAP_PLANES_MAX];	// Nb de codes de chaque plan (snapshots).
 
 	struct SPathBlock	*pPath;
 	struct SPathBlock	*pPathGnd;	// Ptr dans pPath pour les blocs au sol.
@@ -87,14 +88,28 @@ struct SMap
 	u8	*pBlkAnmMem;	// Bloc mmoire pour les 'plans' d'anims de blocs.
 	u8	*ppBlkAnmPlanes[MAP_PLANES_MAX];	// Les plans d'anim de blocs (les pointeurs vont pointer dans pBlkAnmMem).
 
+	upix	*ppBlkTiles[MAP_PLANES_MAX];	// Blocs des planches  la suite (16x16 pixels chacun), pour la copie dans le scroll.
+	u8	*ppBlkOpacity[MAP_PLANES_MAX];	// Opacit de chaque bloc des planches (e_BlkOpa_...).
+	u32	pBlkGfxLg[MAP_PLANES_MAX];		// Largeur des planches, en blocs.
+	u32	pBlkGfxNb[MAP_PLANES_MAX];		// Nb de blocs des planches.
+
 };
 
 extern	struct SMap	gMap;
 
+#define	BLK_TILE_PIX	(16 * 16)	// Taille d'un bloc dans gMap.ppBlkTiles.
 
+// Opacit des blocs, pour le trac des plans transparents.
+enum
+{
+	e_BlkOpa_Mixed = 0,		// Opaque et transparent.
+	e_BlkOpa_Empty,			// Que la couleur transparente.
+	e_BlkOpa_Opaque,		// Pas de couleur transparente (et tous les blocs du plan 0, trac sans transparence).
+};
 
 void LevelLoad(u32 nLevelNo);
 void LevelRelease(void);
+void LevelSnapZones(void);
 
 s32 Map_PathGndGetBlock(s32 nPosX, s32 nPosY);
 s32 Map_PathAirGetBlock(s32 nPosX, s32 nPosY);
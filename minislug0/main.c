@@ -27,6 +27,10 @@ enum
 	e_RenderMode_Normal = 0,
 	e_RenderMode_Scale2x,
 	e_RenderMode_TV2x,
+	e_RenderMode_Scale3x,
+	e_RenderMode_TV3x,
+	e_RenderMode_Scale4x,
+	e_RenderMode_TV4x,
 	//
 	e_RenderMode_MAX
 };
@@ -34,283 +38,50 @@ enum
 // Param�tres de rendu.
 struct SRender	gRender;
 
-// Scaling 2x.
-void Render_Scale2x(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst)
-{
-	SDL_LockSurface(pSDL_Src);
-	SDL_LockSurface(pSDL_Dst);
-
-	u32	y, x;
-	u8	*pSrc = pSDL_Src->pixels;
-	u8	*pDst = pSDL_Dst->pixels;
-	u32	nClr;
-
-	u16	*pSrc2;
-	u32	*pDst2a, *pDst2b;
-
-	for (y = 0; y < SCR_Height; y++)
-	{
-		pSrc2 = (u16 *)pSrc;
-		pDst2a = (u32 *)pDst;
-		pDst2b = (u32 *)(pDst + pSDL_Dst->pitch);
-		for (x = 0; x < SCR_Width; x++)
-		{
-			nClr = *pSrc2++;
-			nClr |= (nClr * 65536);
-			*pDst2a++ = nClr;
-			*pDst2b++ = nClr;
-		}
-		pSrc += pSDL_Src->pitch;
-		pDst += pSDL_Dst->pitch * 2;
-	}
-
-	SDL_UnlockSurface(pSDL_Src);
-	SDL_UnlockSurface(pSDL_Dst);
-}
-
-u16	gpTV2xCLUT[65536];
-
-// Calcul de la grosse CLUT pour le mode TV2x.
-#define	TV2x_FACTOR	200		// * factor, / 256
-void TV2x_CalculateCLUT(SDL_Surface *pSDL_Dst)
-{
-	u32	i;
-	u8	r, g, b;
-
-	for (i = 0; i < 65536; i++)
-	{
-		SDL_GetRGB(i, pSDL_Dst->format, &r, &g, &b);
-		r = ((u32)r * TV2x_FACTOR) / 256;
-		g = ((u32)g * TV2x_FACTOR) / 256;
-		b = ((u32)b * TV2x_FACTOR) / 256;
-		gpTV2xCLUT[i] = SDL_MapRGB(pSDL_Dst->format, r, g, b);
-	}
-}
-
-// TV2x.
-void Render_TV2x(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst)
-{
-	SDL_LockSurface(pSDL_Src);
-	SDL_LockSurface(pSDL_Dst);
-
-	u32	y, x;
-	u8	*pSrc = pSDL_Src->pixels;
-	u8	*pDst = pSDL_Dst->pixels;
-	u32	nClra, nClrb;
-
-	u16	*pSrc2;
-	u32	*pDst2a, *pDst2b;
-
-	for (y = 0; y < SCR_Height; y++)
-	{
-		pSrc2 = (u16 *)pSrc;
-		pDst2a = (u32 *)pDst;
-		pDst2b = (u32 *)(pDst + pSDL_Dst->pitch);
-		for (x = 0; x < SCR_Width; x++)
-		{
-			nClra = *pSrc2++;
-			nClrb = gpTV2xCLUT[nClra];
-			nClra |= (nClra * 65536);
-			nClrb |= (nClrb * 65536);
-			*pDst2a++ = nClra;
-			*pDst2b++ = nClrb;
-		}
-		pSrc += pSDL_Src->pitch;
-		pDst += pSDL_Dst->pitch * 2;
-	}
-
-	SDL_UnlockSurface(pSDL_Src);
-	SDL_UnlockSurface(pSDL_Dst);
-}
-
-
-#ifdef	RENDER_BPP
-u32	gpR2x_32_CLUT[65536];
-u32	gpTV2x_32_CLUT[65536];
-
-// Calcul des CLUT 32 bits.
-void R2x_32_CalculateCLUT(void)
-{
-	u32	i;
-	u8	r, g, b;
-
-	SDL_Surface *pSrc;
-	SDL_Surface *pDst;
-/*
-//> *** BPP Solution 1. > Sur Mac, pose probl�me � cause des masques des surfaces et �cran qui sont diff�rents.
-	pSrc = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 32, 0, 0, 0, 0);
-	pDst = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 32, 0, 0, 0, 0);
-//<
-*/
-
-/*
-//> *** BPP Solution 2.
-//> Modif Pouet pour Mac. > Donne du bleu sur PC.
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-	int mask16r = 0x001F;
-	int mask16g = 0x07E0;
-	int mask16b = 0xF800;
-	int mask16a = 0x0000;
-	int mask32r = 0xFF000000;
-	int mask32g = 0x00FF0000;
-	int mask32b = 0x0000FF00;
-	int mask32a = 0x000000FF;
-#else
-	int mask16r = 0xF800;
-	int mask16g = 0x07E0;
-	int mask16b = 0x001F;
-	int mask16a = 0x0000;
-	int mask32r = 0x000000FF;
-	int mask32g = 0x0000FF00;
-	int mask32b = 0x00FF0000;
-	int mask32a = 0xFF000000;
-#endif
-	pSrc = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 16, mask16r, mask16g, mask16b, mask16a);
-	pDst = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 32, mask32r, mask32g, mask32b, mask32a);
-//< Modif Pouet pour Mac.
-//<
-*/
-
-//> *** BPP Solution 3. Ok partout, mais la manip dans InitVideo n'est pas tr�s jolie...
-	pSrc = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 16, gRender.pScreenBuf2->format->Rmask, gRender.pScreenBuf2->format->Gmask, gRender.pScreenBuf2->format->Bmask, 0);
-	pDst = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 32, gVar.pScreen->format->Rmask, gVar.pScreen->format->Gmask, gVar.pScreen->format->Bmask, 0);
-//<
-	if (pSrc == NULL || pDst == NULL)
-	{
-		fprintf(stderr, "R2x_32_CalculateCLUT(): Unable to allocate SDL surfaces.\n");
-		exit(1);
-	}
-
-	for (i = 0; i < 65536; i++)
-	{
-		SDL_GetRGB(i, pSrc->format, &r, &g, &b);
-		gpR2x_32_CLUT[i] = SDL_MapRGB(pDst->format, r, g, b);
-		r = ((u32)r * TV2x_FACTOR) / 256;
-		g = ((u32)g * TV2x_FACTOR) / 256;
-		b = ((u32)b * TV2x_FACTOR) / 256;
-		gpTV2x_32_CLUT[i] = SDL_MapRGB(pDst->format, r, g, b);
-	}
-
-	SDL_FreeSurface(pSrc);
-	SDL_FreeSurface(pDst);
-
-}
-
-// Scaling 2x - 16 > 32.
-void Render_Scale2x_16to32(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst)
-{
-	SDL_LockSurface(pSDL_Src);
-	SDL_LockSurface(pSDL_Dst);
-
-	u32	y, x;
-	u8	*pSrc = pSDL_Src->pixels;
-	u8	*pDst = pSDL_Dst->pixels;
-	u32	nClr;
-
-	u16	*pSrc2;
-	u32	*pDst2a, *pDst2b;
-
-	for (y = 0; y < SCR_Height; y++)
-	{
-		pSrc2 = (u16 *)pSrc;
-		pDst2a = (u32 *)pDst;
-		pDst2b = (u32 *)(pDst + pSDL_Dst->pitch);
-		for (x = 0; x < SCR_Width; x++)
-		{
-			nClr = gpR2x_32_CLUT[*pSrc2++];
-			*pDst2a++ = nClr;
-			*pDst2a++ = nClr;
-			*pDst2b++ = nClr;
-			*pDst2b++ = nClr;
-		}
-		pSrc += pSDL_Src->pitch;
-		pDst += pSDL_Dst->pitch * 2;
-	}
-
-	SDL_UnlockSurface(pSDL_Src);
-	SDL_UnlockSurface(pSDL_Dst);
-}
-
-// TV2x - 16 > 32.
-void Render_TV2x_16to32(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst)
-{
-	SDL_LockSurface(pSDL_Src);
-	SDL_LockSurface(pSDL_Dst);
-
-	u32	y, x;
-	u8	*pSrc = pSDL_Src->pixels;
-	u8	*pDst = pSDL_Dst->pixels;
-	u32	nClra, nClrb;
+// Facteur d'agrandissement et lignes TV de chaque mode.
+u8	gpRenderFactor[e_RenderMode_MAX] = { 1, 2, 2, 3, 3, 4, 4 };
+u8	gpRenderTV[e_RenderMode_MAX] = { 0, 0, 1, 0, 1, 0, 1 };
 
-	u16	*pSrc2;
-	u32	*pDst2a, *pDst2b;
-
-	for (y = 0; y < SCR_Height; y++)
-	{
-		pSrc2 = (u16 *)pSrc;
-		pDst2a = (u32 *)pDst;
-		pDst2b = (u32 *)(pDst + pSDL_Dst->pitch);
-		for (x = 0; x < SCR_Width; x++)
-		{
-			nClra = gpR2x_32_CLUT[*pSrc2];
-			nClrb = gpTV2x_32_CLUT[*pSrc2++];
-			*pDst2a++ = nClra;
-			*pDst2a++ = nClra;
-			*pDst2b++ = nClrb;
-			*pDst2b++ = nClrb;
-		}
-		pSrc += pSDL_Src->pitch;
-		pDst += pSDL_Dst->pitch * 2;
-	}
-
-	SDL_UnlockSurface(pSDL_Src);
-	SDL_UnlockSurface(pSDL_Dst);
-}
-
-#endif
-
-
-extern	u8	gnFrameMissed;
-typedef void (*pRenderFct)(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst);
 // Rendu + Flip.
 void RenderFlip(u32 nSync)
 {
-#ifdef	RENDER_BPP
-	static pRenderFct	pFctTb[2][e_RenderMode_MAX] =
-	{
-		{ NULL, Render_Scale2x, Render_TV2x },	// Screen 16 bits.
-		{ NULL, Render_Scale2x_16to32, Render_TV2x_16to32 },	// Screen 32 bits.
-	};
-#else
-	static pRenderFct	pFctTb[e_RenderMode_MAX] = { NULL, Render_Scale2x, Render_TV2x };
-#endif
-
 	// Frames loup�es ? => Pas de Rendu/Flip.
 	if (nSync && gnFrameMissed)
 	{
+		PROF_START(e_Prof_Wait);
 		FrameWait();
+		PROF_STOP(e_Prof_Wait);
+		ProfFrameEnd(1);
 		return;
 	}
 
-#ifdef	RENDER_BPP
-	if (pFctTb[gRender.nRenderBPP][gRender.nRenderMode] != NULL) pFctTb[gRender.nRenderBPP][gRender.nRenderMode](gVar.pScreen, gRender.pScreen2x);
-#else
-	if (pFctTb[gRender.nRenderMode] != NULL) pFctTb[gRender.nRenderMode](gVar.pScreen, gRender.pScreen2x);
-#endif
-	if (nSync) FrameWait();
-	{ SDL_Surface *pReal = SDL_GetWindowSurface(gVar.pWindow); SDL_Surface *pS = (gRender.nRenderMode != 0 && gRender.pScreen2x) ? gRender.pScreen2x : gVar.pScreen; if(pReal) SDL_BlitSurface(pS, NULL, pReal, NULL); } SDL_UpdateWindowSurface(gVar.pWindow);
+	ReplayScreen();		// Rejeu : Hash de l'image de la frame de controle (sans l'overlay).
+	ProfOverlayDraw();	// Profiler : graphe des dernieres frames (F11).
+
+	PROF_START(e_Prof_Present);
+	RCtx_FrameEnd();	// Fin des traces de la frame (unlock unique).
+
+	// Scaling directement dans la destination finale (fenetre ou texture).
+	if (gRender.nNoPresent == 0) PresentDraw(gVar.pScreen, gpRenderTV[gRender.nRenderMode]);
+	PROF_STOP(e_Prof_Present);
+	PROF_START(e_Prof_Wait);
+	if (nSync && gPresent.nVSync == 0) FrameWait();
+	PROF_STOP(e_Prof_Wait);
+	PROF_START(e_Prof_Present);
+	if (gRender.nNoPresent == 0) PresentFlip();
+	PROF_STOP(e_Prof_Present);
+	// Vsync : Image presentee au rafraichissement, puis representee en attendant la frame logique suivante (cf. frame.c).
+	PROF_START(e_Prof_Wait);
+	if (nSync && gPresent.nVSync) FrameWait();
+	PROF_STOP(e_Prof_Wait);
+	ProfFrameEnd(0);
 
 }
 
-// Set video mode.
-#ifdef	RENDER_BPP
-SDL_Surface * VideoModeSet(u32 nScrWidth, u32 nScrHeight, u32 nBPP, u32 nSDL_Flags)
-#else
-SDL_Surface * VideoModeSet(u32 nScrWidth, u32 nScrHeight, u32 nSDL_Flags)
-#endif
+// Set video mode. (Cree ou met a jour la fenetre).
+// Out : 0 = Erreur / 1 = Ok.
+u32 VideoModeSet(u32 nScrWidth, u32 nScrHeight, u32 nSDL_Flags)
 {
-	SDL_Surface *pSurf;
-
 	// Create or recreate window if needed
 	if (gVar.pWindow == NULL)
 	{
@@ -320,7 +91,7 @@ SDL_Surface * VideoModeSet(u32 nScrWidth, u32 nScrHeight, u32 nSDL_Flags)
 		if (gVar.pWindow == NULL)
 		{
 			fprintf(stderr, "VideoModeSet(): Couldn't create window: %s\n", SDL_GetError());
-			return NULL;
+			return (0);
 		}
 	}
 	else
@@ -329,96 +100,53 @@ SDL_Surface * VideoModeSet(u32 nScrWidth, u32 nScrHeight, u32 nSDL_Flags)
 		SDL_SetWindowSize(gVar.pWindow, nScrWidth, nScrHeight);
 		SDL_SetWindowFullscreen(gVar.pWindow, nSDL_Flags);
 	}
-
-	pSurf = SDL_CreateRGBSurface(0, nScrWidth, nScrHeight, 16, 0xF800, 0x07E0, 0x001F, 0);
-	if (pSurf == NULL)
-	{
-		fprintf(stderr, "VideoModeSet(): Couldn't get window surface: %s\n", SDL_GetError());
-	}
-	return (pSurf);
+	PresentReset();		// La surface de la fenetre a change.
+	return (1);
 }
 
 // Met le mode video qui va bien.
+// Le jeu trace toujours dans gVar.pScreen (320x224), seule la taille de la fenetre depend du mode.
 void Render_SetVideoMode(void)
 {
-	switch (gRender.nRenderMode)
-	{
-	case e_RenderMode_Scale2x:
-	case e_RenderMode_TV2x:
-#ifdef	RENDER_BPP
-		gRender.pScreen2x = VideoModeSet(SCR_Width * 2, SCR_Height * 2, 16 << gRender.nRenderBPP, (gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0));
-#else
-		gRender.pScreen2x = VideoModeSet(SCR_Width * 2, SCR_Height * 2, (gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0));
-#endif
-		gVar.pScreen = gRender.pScreenBuf2;
-		if (gRender.pScreen2x != NULL) return;		// Ok.
-		// Erreur => On repasse en mode Normal et Windowed.
-		gRender.nRenderMode = e_RenderMode_Normal;
-		gRender.nFullscreenMode = 0;
-		// ... et pas de break.
-	case e_RenderMode_Normal:
-	default:
-#ifdef	RENDER_BPP
-		gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, 16, (gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0));
-#else
-		gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, (gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0));
-#endif
-		gRender.pScreen2x = NULL;
-		if (gVar.pScreen == NULL) exit(1);	// Message d'erreur dans VideoModeSet.
-		break;
-	}
+	u32	nFactor;
 
+	nFactor = gpRenderFactor[gRender.nRenderMode];
+	if (VideoModeSet(SCR_Width * nFactor, SCR_Height * nFactor, (gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0))) return;		// Ok.
+	// Erreur => On repasse en mode Normal et Windowed.
+	gRender.nRenderMode = e_RenderMode_Normal;
+	gRender.nFullscreenMode = 0;
+	if (VideoModeSet(SCR_Width, SCR_Height, 0) == 0) exit(1);	// Message d'erreur dans VideoModeSet.
 }
 
-// Init de la vid�o.
+// Init de la video.
 void Render_InitVideo(void)
 {
 	gRender.nRenderMode = e_RenderMode_Normal;
 	gRender.nFullscreenMode = 0;
 
-	gRender.pScreen2x = NULL;		// En mode 2x, ptr sur la surface �cran.
-	gRender.pScreenBuf2 = NULL;		// Buffer de rendu pour le jeu en mode 2x (� la place de la surface �cran r�elle).
-
-	// On initialise d'abord un �cran en mode e_RenderMode_Normal. Important, car on fait un CreateRGBSurface � partir de cette surface.
-#ifdef	RENDER_BPP
-	gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, 16, gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0);
-#else
-	gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0);
-#endif
-	if (gVar.pScreen == NULL) exit(1);
-	// On cr�� un buffer de la taille de l'�cran.
-	// => En mode 2x, on switche le ptr pScreen sur cette surface, les rendus du jeu se font donc dedans. Puis on fait le scale/filtre du buffer vers la vraie surface �cran.
-	gRender.pScreenBuf2 = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, 32, 0, 0, 0, 0);
+	// Fenetre en mode e_RenderMode_Normal.
+	if (VideoModeSet(SCR_Width, SCR_Height, gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0) == 0) exit(1);
+	// Buffer ecran du jeu, 565 ou XRGB8888 (FB32_ON). Les scalers font l'agrandissement et la conversion vers le format de sortie.
+	gRender.pScreenBuf2 = SDL_CreateRGBSurface(0, SCR_Width, SCR_Height, FB_BPP, FB_RMASK, FB_GMASK, FB_BMASK, 0);
 	if (gRender.pScreenBuf2 == NULL)
 	{
 		fprintf(stderr, "Render_InitVideo(): Unable to allocate SDL surface: %s\n", SDL_GetError());
 		exit(1);
 	}
+	gVar.pScreen = gRender.pScreenBuf2;
 
-	// Calcul de la CLUT pour le mode TV2x.
-	TV2x_CalculateCLUT(gVar.pScreen);
-#ifdef	RENDER_BPP
-	// Calcul des CLUTs pour les mode 32 bits.
-	if (gRender.nRenderBPP)
-	{
-/*
-//> *** BPP Solution 1.
-		//R2x_32_CalculateCLUT();
-//<
-*/
-//> *** BPP Solution 3.
-		gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, 32, gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0);
-		//R2x_32_CalculateCLUT();
-		gVar.pScreen = VideoModeSet(SCR_Width, SCR_Height, 16, gRender.nFullscreenMode ? SDL_WINDOW_FULLSCREEN : 0);
-//<
-	}
-#endif
+	// Scalers (tables de conversion, threads).
+	ScalerInit();
+	// Presentation. Vsync si l'ecran est plus rapide que la logique (sauf -novsync, ou pas de cadencement).
+	PresentInit(gRender.nPresent, (gRender.nNoVSync == 0 && gRender.nNoPresent == 0 && gFrame.nUnthrottled == 0));
 
 }
 
 // Lib�re les ressources du rendu. (1 fois !).
 void RenderRelease(void)
 {
+	PresentRelease();
+	ScalerRelease();
 	SDL_FreeSurface(gRender.pScreenBuf2);
 }
 
@@ -567,6 +295,10 @@ int EventHandler(u32 nInGame)
 				if (++gRender.nRenderMode >= e_RenderMode_MAX) gRender.nRenderMode = 0;
 				Render_SetVideoMode();
 			}
+#if PROF_ON == 1
+			// Toggle profiler overlay.
+			if (event.key.keysym.scancode == SDL_SCANCODE_F11) ProfOverlayToggle();
+#endif
 
 #ifdef	DEBUG_KEYS
 			if (gVar.pKeys[SDL_SCANCODE_ESCAPE]) return (1);	// Emergency exit.
@@ -626,6 +358,9 @@ int EventHandler(u32 nInGame)
 
 	}
 
+	// Enregistrement / rejeu des entrees de la partie.
+	if (nInGame) ReplayFrame();
+
 	return (0);
 }
 
@@ -662,7 +397,9 @@ u32 Menu(void (*pFctInit)(void), u32 (*pFctMain)(void))
 		// Menu Main.
 		nMenuVal = (*pFctMain)();
 
+		PROF_START(e_Prof_Spr);
 		SprDisplayAll();
+		PROF_STOP(e_Prof_Spr);
 
 #ifdef	DEBUG_KEYS
 //>> test pour ralentir l'affichage.
@@ -670,7 +407,9 @@ if (gVar.pKeys[SDL_SCANCODE_Y]) { FrameWait(); FrameWait(); FrameWait(); FrameWa
 #endif
 
 		// Affichage de la transition.
+		PROF_START(e_Prof_Transit);
 		Transit2D_Manage();
+		PROF_STOP(e_Prof_Transit);
 //		// Wait for frame, Flip.
 //		FrameWait();
 //		SDL_Flip(gVar.pScreen);
@@ -729,6 +468,7 @@ u32 Pause(void)
 	u32	nFrame_sav = gnFrame;
 
 	// Current screen => background.
+	RCtx_BlitPrepare();
 	SDL_BlitSurface(gVar.pScreen, NULL, pBkg, NULL);
 
 	Sfx_ChannelsSave();		// Save data + clear currently playing sounds.
@@ -740,18 +480,18 @@ u32 Pause(void)
 	u32	y, x;
 	u8	*pSrc = pBkg->pixels;
 	u32	nClr;
-	u16	*pSrc2;
+	upix	*pSrc2;
 
 	for (y = 0; y < SCR_Height; y++)
 	{
-		pSrc2 = (u16 *)pSrc;
+		pSrc2 = (upix *)pSrc;
 		for (x = 0; x < SCR_Width; x++)
 		{
 /*
 			// v1 : Shade only.
-			nClr = gpTV2xCLUT[*pSrc2];
-			nClr = gpTV2xCLUT[nClr];
-			nClr = gpTV2xCLUT[nClr];
+			nClr = SCALER_TV16(*pSrc2);
+			nClr = SCALER_TV16(nClr);
+			nClr = SCALER_TV16(nClr);
 			*pSrc2++ = nClr;
 */
 
@@ -761,10 +501,10 @@ u32 Pause(void)
 
 			SDL_GetRGB(*pSrc2, gVar.pScreen->format, &r, &g, &b);
 			nClr = (r * 0.299) + (g * 0.587) + (b * 0.114);
-			nClr = SDL_MapRGB(gVar.pScreen->format, nClr, nClr, nClr);
-			nClr = gpTV2xCLUT[nClr];
-			nClr = gpTV2xCLUT[nClr];
-			*pSrc2++ = nClr;
+			// Note : Pas identique au bit pres a l'ancien calcul (2x SCALER_TV16 sur le 565), voulu : Le shade est fait sur
+			// le gris 8 bits avant SDL_MapRGB, donc un seul arrondi, et le meme resultat en 16 et en 32 bits.
+			nClr = (nClr * SCALER_TV_FACTOR * SCALER_TV_FACTOR) >> 16;	// Shade x2, comme les lignes TV (quel que soit le format).
+			*pSrc2++ = SDL_MapRGB(gVar.pScreen->format, nClr, nClr, nClr);
 
 		}
 		pSrc += pBkg->pitch;
@@ -831,6 +571,7 @@ u32 Pause(void)
 		}
 
 		// Bkg.
+		RCtx_BlitPrepare();
 		SDL_BlitSurface(pBkg, NULL, gVar.pScreen, NULL);
 		// Txt.
 		Pause_sub_TxtDisplay(pTxt, pnTxtSz, nChoice);
@@ -851,6 +592,7 @@ u32 Pause(void)
 		Transit2D_InitClosing(e_Transit_Menu);
 		while (Transit2D_CheckEnd() == 0)
 		{
+			RCtx_BlitPrepare();
 			SDL_BlitSurface(pBkg, NULL, gVar.pScreen, NULL);	// Bkg.
 			Pause_sub_TxtDisplay(pTxt, pnTxtSz, nChoice);		// Txt.
 			SprDisplayAll();
@@ -902,7 +644,9 @@ if (gVar.pKeys[SDL_SCANCODE_Y]) { FrameWait(); FrameWait(); FrameWait(); FrameWa
 #endif
 
 		// Affichage de la transition.
+		PROF_START(e_Prof_Transit);
 		Transit2D_Manage();
+		PROF_STOP(e_Prof_Transit);
 		// Wait for frame, Flip.
 //		RenderFlip(1);
 #ifdef	DEBUG_KEYS
@@ -943,6 +687,9 @@ void Game(void)
 		gGameVar.nBestScore = nPlayerScore_sav;
 	}
 
+	// Rejeu : Pas de game over ni de high score.
+	if (gReplay.nMode == e_Replay_Play) return;
+
 	// Game Over.
 	Music_Start(e_YmMusic_GameOver, 1);
 	Menu(MenuGameOver_Init, MenuGameOver_Main);
@@ -1035,6 +782,7 @@ void SpritesLoad(void)
 		fprintf(stderr, "Couldn't load picture 'bkg_disk.bmp': %s\n", SDL_GetError());
 		exit(1);
 	}
+	RCtx_BlitPrepare();
 	SDL_BlitSurface(pBkg, NULL, gVar.pScreen, NULL);
 	SDL_FreeSurface(pBkg);
 	// Pr�paration des prm fixes de l'indicateur.
@@ -1204,6 +952,40 @@ int main(int argc, char *argv[])
 	}
 
 
+	// Options de la ligne de commande.
+	ProfInit();
+	SnapInit();		// Snapshots (sauvegardes en memoire, rembobinage).
+	for (i = 1; i < (u32)argc; i++)
+	{
+		if (strcmp(argv[i], "-atlas") == 0) SprSpanAtlasSet(1);			// Sprites : Atlas 16 bits, pas de conversion au trace.
+		else if (strcmp(argv[i], "-noatlas") == 0) SprSpanAtlasSet(0);	// Sprites : Index 8 bits, moins de memoire.
+		else if (strcmp(argv[i], "-texture") == 0) gRender.nPresent = e_Present_Texture;	// Presentation via une texture streaming.
+		else if (strcmp(argv[i], "-novsync") == 0) gRender.nNoVSync = 1;	// Pas de presentation au rythme de l'ecran.
+		else if (strcmp(argv[i], "-prof") == 0) gProf.nCsv = 1;		// Profiler : Dump CSV des dernieres frames a la sortie.
+		else if (strcmp(argv[i], "-cachestats") == 0) gnCacheStatsCsv = 1;	// Stats du cache de chaque niveau dans cachestats.csv.
+		else if (strcmp(argv[i], "-record") == 0 && i + 1 < (u32)argc) ReplayRecordSet(argv[++i]);	// Enregistrement des entrees de la prochaine partie.
+		else if (strcmp(argv[i], "-replay") == 0 && i + 1 < (u32)argc) ReplayPlaySet(argv[++i]);	// Rejeu d'une partie enregistree, puis sortie.
+		else if (strcmp(argv[i], "-botrecord") == 0 && i + 3 < (u32)argc) { ReplayBotSet(argv[i + 1], atoi(argv[i + 2]), atoi(argv[i + 3])); i += 3; }	// Enregistrement scripte (cf. bench/mkcorpus.sh).
+		else if (strcmp(argv[i], "-headless") == 0)		// Pas de fenetre ni de son, pas de cadencement, compte rendu a la sortie.
+		{
+			SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+			SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+			gFrame.nUnthrottled = 1;
+			gProf.nSummary = 1;
+		}
+		else if (strcmp(argv[i], "-snap") == 0) SnapEnable();	// Snapshots : F7 sauve / F8 recharge / F4 rembobine.
+		else if (strcmp(argv[i], "-nosync") == 0) gFrame.nUnthrottled = 1;	// Pas de cadencement.
+		else if (strcmp(argv[i], "-json") == 0 && i + 1 < (u32)argc) gProf.pJsonFilename = argv[++i];	// Compte rendu headless en JSON (benchmark).
+		else if (strcmp(argv[i], "-norender") == 0) gRender.nNoPresent = 1;	// Trace, mais pas de scaling ni de presentation.
+		else if (strcmp(argv[i], "-noraster") == 0) { gRender.nNoPresent = 1; gFrame.nNoRaster = 1; }	// Pas de trace du tout (avec -nosync/-headless).
+	}
+	// Headless : Pas de clavier, les entrees viennent d'un fichier (ou du bot).
+	if (gProf.nSummary && gReplay.nMode != e_Replay_Play && gReplay.nBot == 0)
+	{
+		fprintf(stderr, "-headless needs -replay <file> or -botrecord.\n");
+		exit(1);
+	}
+
 	// SDL Init.
 //	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_AUDIO) < 0)
@@ -1213,6 +995,7 @@ int main(int argc, char *argv[])
 	}
 	// atexit : Quand on quittera (exit, return...), SDL_Quit() sera appel�e.
 	atexit(SDL_Quit);
+	atexit(ProfRelease);	// Dump du profiler, meme sur fermeture de la fenetre (exit).
 
 #ifdef	RENDER_BPP
 	SDL_DisplayMode displayMode;
@@ -1282,7 +1065,8 @@ _JoyOff:
 	// Init du clavier.
 	gVar.pKeysSDL = SDL_GetKeyboardState(NULL);
 	memset(gVar.pKeys, 0, SDL_NUM_SCANCODES);
-	// Allocation des buffers de scroll.
+	// Contexte de rendu, puis allocation des buffers de scroll.
+	RCtxInit();
 	ScrollAllocate();
 
 	// Preca Sinus et Cosinus.
@@ -1354,6 +1138,8 @@ _JoyOff:
 
 	// Boucle infinie.
 	nMenuVal = MENU_Main;//MENU_Game;
+	if (gReplay.nMode == e_Replay_Play) nMenuVal = gReplay.sHdr.nGame;	// Rejeu : Directement dans la partie.
+	if (gReplay.nBot) nMenuVal = MENU_Game;		// Bot : Idem.
 	nLoop = 1;
 	while (nLoop)
 	{
@@ -1364,12 +1150,16 @@ _JoyOff:
 			break;
 
 		case MENU_Game:		// Jeu.
+			ReplayGameStart(MENU_Game);
 			Game();
+			ReplayGameEnd();
 			nMenuVal = MENU_Main;
 			break;
 
 		case MENU_Roguelike:	// Roguelike mode.
+			ReplayGameStart(MENU_Roguelike);
 			RoguelikeGame();
+			ReplayGameEnd();
 			nMenuVal = MENU_Main;
 			break;
 
@@ -1414,6 +1204,8 @@ _JoyOff:
 	SprRelease();
 	// Lib�re les buffers de scroll.
 	ScrollRelease();
+	// Snapshots.
+	SnapRelease();
 	// Free the allocated surfaces.
 	for (i = 0; i < MENU_NbBkg; i++)
 	{
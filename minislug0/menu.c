@@ -160,12 +160,10 @@ void Credits_Display(s32 nCreditsNb)
 
 //=============================================================================
 
-extern	u8	gnFrameMissed;
-
 // Affichage d'une image GIF.
 void GIF_Display(struct SGIFFile *pGif, u32 nBkgColor, s32 nPosX, s32 nPosY)
 {
-	u16	pPal[256];
+	upix	pPal[256];
 	s32	nXMin, nXMax, nYMin, nYMax;
 	s32	nSprXMin, nSprXMax, nSprYMin, nSprYMax;
 	s32	diff;
@@ -212,14 +210,14 @@ void GIF_Display(struct SGIFFile *pGif, u32 nBkgColor, s32 nPosX, s32 nPosY)
 	if (nSprYMin - nSprYMax >= 0) return;
 
 
-	SDL_LockSurface(gVar.pScreen);
+	struct SRenderCtx	*pCtx = RCTX();
 
-	u16	*pScr = (u16 *)gVar.pScreen->pixels;
+	upix	*pScr = pCtx->pScr;
 	u8	*pGfx = pGif->pImg;
-	u32	nScrLg = gVar.pScreen->pitch / sizeof(u16);
+	u32	nScrLg = pCtx->nScrPitch;
 	s32	ix, iy;
 
-	// Conversion de la palette en format 16 bits.
+	// Conversion de la palette au format de l'ecran.
 	for (ix = 0; ix < 256; ix++) pPal[ix] = SDL_MapRGB(gVar.pScreen->format, pGif->pPal[ix * 3], pGif->pPal[ix * 3 + 1], pGif->pPal[ix * 3 + 2]);
 	// Une couleur de transparence ?
 	if (pGif->nTransparentColorIndex < 256) pPal[pGif->nTransparentColorIndex] = nBkgColor;
@@ -281,8 +279,6 @@ _SkipTrans:
 		}
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
-
 }
 
 // Bkg qui scrolle, image 128 x 128.
@@ -292,6 +288,7 @@ void Bkg1Scroll(u32 nOffsetX, u32 nOffsetY)
 	SDL_Rect	sSrc, sDst;
 
 	if (gnFrameMissed) return;
+	RCtx_BlitPrepare();
 
 	sSrc.y = nOffsetY & 0x3F;
 	sSrc.h = gVar.pBackground->h - sSrc.y;
@@ -528,11 +525,11 @@ void Pixelizer(SDL_Surface *pSurf8, u32 nPixSz)
 	u32	nPosX, nPosY, nResetPosX;
 	u32	nOffsX, nOffsY;
 	u32	nZoom;
-	u16	*pScr;
-	u16	nClr;
+	upix	*pScr;
+	upix	nClr;
 	u32	nRemLn;
 
-	u16	pPal[256];
+	upix	pPal[256];
 
 	// La palette.
 	for (ix = 0; ix < 256; ix++)
@@ -544,9 +541,8 @@ void Pixelizer(SDL_Surface *pSurf8, u32 nPixSz)
 	}
 
 	// L'effet.
-	SDL_LockSurface(gVar.pScreen);
-	pScr = (u16 *)gVar.pScreen->pixels;
-	nRemLn = (gVar.pScreen->pitch / sizeof(u16)) - SCR_Width;
+	pScr = RCTX()->pScr;
+	nRemLn = RCTX()->nScrPitch - SCR_Width;
 
 	nZoom = 0x1000 / nPixSz;
 
@@ -581,8 +577,6 @@ void Pixelizer(SDL_Surface *pSurf8, u32 nPixSz)
 		}
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
-
 }
 
 #define	GAMEOVER_TIMEOUT	(60)	//(180)
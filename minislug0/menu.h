@@ -71,7 +71,7 @@ enum
 struct SMSCfg
 {
 	u16	pKeys[e_CfgKey_MAX];
-	u16	nVideoMode;			// 0 = 320x224 / 1 = x2 / 2 = TV2x.
+	u16	nVideoMode;			// 0 = 320x224 / 1 = x2 / 2 = TV2x / 3 = x3 / 4 = TV3x / 5 = x4 / 6 = TV4x.
 	u16	nChecksum;
 };
 #pragma pack()
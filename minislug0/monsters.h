@@ -90,5 +90,8 @@ extern u8	gpnMstCount[e_Mst_MAX];		// Compte des monstres par type. Ici 
 // Prototypes.
 void MstSlug_EntrancePtGet(u32 nSlugType, s32 *pnOffsX, s32 *pnOffsY);
 void Rot2D_RotatePoint(s32 *pnOffsX, s32 *pnOffsY, u8 nAngle);
+void Mst20SnapZones(void);
+void Mst30SnapZones(void);
+void Mst50SnapZones(void);
 
 
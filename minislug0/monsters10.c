@@ -12,7 +12,7 @@
 void Mst10_Init_Jellyfish(struct SMstCommon *pMst, u8 *pData)
 {
 	pMst->nSpd = -MST10_SPD;
-	pMst->nSpdY = -(rand() & 0x38);	// Un peu d'alatoire dans la vitesse.
+	pMst->nSpdY = -(Rnd() & 0x38);	// Un peu d'alatoire dans la vitesse.
 
 }
 
@@ -497,7 +497,7 @@ Mst14_sub_ZoneMinMax(&nZoneMin, &nZoneMax, pMst);
 	if (nHt > 14)
 	{
 		// On arrive en bout de plateforme. Saut ?
-		if (pSpe->nJump == 2 || (pSpe->nJump == 1 && (rand() & 1)))
+		if (pSpe->nJump == 2 || (pSpe->nJump == 1 && (Rnd() & 1)))
 		{
 			pMst->nPhase = e_Mst14_Jump;	// Saut.
 			pMst->nSpd = MST14_MORTAR_SPD;	// Pour amortissement de la vitesse x.
@@ -779,7 +779,7 @@ s32 Mst14Sub_Main_LRACSoldier0(struct SMstCommon *pMst)
 					nAdd = 0;
 					// Repasse en wait aprs le tir.
 					pMst->nPhase = e_Mst14_Wait;
-					pSpe->nCntWait = (rand() & 127) | 31;	// Petite attente...
+					pSpe->nCntWait = (Rnd() & 127) | 31;	// Petite attente...
 				}
 			}
 			else
@@ -901,7 +901,7 @@ s32 Mst14Sub_Main_MortarSoldier0(struct SMstCommon *pMst)
 			// On arrive en bout de plateforme. Saut ?
 			if (nHt > 10)
 			{
-				if (pSpe->nJump == 2 || (pSpe->nJump == 1 && (rand() & 1)))
+				if (pSpe->nJump == 2 || (pSpe->nJump == 1 && (Rnd() & 1)))
 				{
 					pMst->nPhase = e_Mst14_Jump;	// Saut.
 					pMst->nSpd = MST14_MORTAR_SPD;	// Pour amortissement de la vitesse x.
@@ -930,7 +930,7 @@ _M14_Mortar_Stop:
 		{
 			// Repasse en wait aprs le tir.
 			pMst->nPhase = e_Mst14_Wait;
-			pSpe->nCntWait = (rand() & 127) | 31;	// Petite attente...
+			pSpe->nCntWait = (Rnd() & 127) | 31;	// Petite attente...
 			break;
 		}
 		break;
@@ -1060,7 +1060,7 @@ s32 Mst14Sub_Main_RifleSoldier0(struct SMstCommon *pMst)
 		nSpr = AnmGetLastImage(pMst->nAnm);
 		if (Mst_ShotLaunch(pMst, nSpr, gpMST14_ShotTb[pSpe->nType], gpMST14_AnmShotDustTb[pSpe->nType]))
 		{
-			pSpe->nCntWait = (rand() & 127) | 31;	// Petite attente...
+			pSpe->nCntWait = (Rnd() & 127) | 31;	// Petite attente...
 			// Repasse en wait aprs le tir.
 			pMst->nPhase = e_Mst14_Wait;
 			// Si cachette, repasse en mode cach derrire un obstacle. Les autres tests (dst + sens) seront faits dans l'autre phase.
@@ -1150,7 +1150,7 @@ s32 Mst14Sub_Main_RifleSoldier0(struct SMstCommon *pMst)
 		if (--pSpe->nCntWait == 0)	// Compteur pour viter de frapper sans arrt.
 		{
 			pMst->nPhase = e_Mst14_Wait;
-			pSpe->nCntWait = (rand() & 127) | 31;	// Reset attente pour le tir...
+			pSpe->nCntWait = (Rnd() & 127) | 31;	// Reset attente pour le tir...
 		}
 		break;
 
@@ -1229,7 +1229,7 @@ s32 Mst14Sub_Main_GunSoldier0(struct SMstCommon *pMst)
 		{
 			// Repasse en wait aprs le tir.
 			pMst->nPhase = e_Mst14_Wait;
-			pSpe->nCntWait = (rand() & 127) | 31;	// Petite attente...
+			pSpe->nCntWait = (Rnd() & 127) | 31;	// Petite attente...
 			break;
 		}
 		break;
@@ -1766,15 +1766,15 @@ s32 Mst15_Main_Truck0(struct SMstCommon *pMst)
 			RESERVED2 = 27:31:
 			*/
 			static u8 pM14[] = { 3, 3, 0, 1 };	// Pour gnrer des soldats, sauf LRAC.
-			//u32	nPrm = (rand() & 1) | (1 * 4096) | (1 << 23);	// 0 = Rifle - 1 = Mortar / 1 * 4096 = Move / 1 << 23 = truck jump.
-			u32	nPrm = ((u32)pM14[rand() & 3]) | (1 * 4096) | (1 << 23);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 1 << 23 = truck jump.
+			//u32	nPrm = (Rnd() & 1) | (1 * 4096) | (1 << 23);	// 0 = Rifle - 1 = Mortar / 1 * 4096 = Move / 1 << 23 = truck jump.
+			u32	nPrm = ((u32)pM14[Rnd() & 3]) | (1 * 4096) | (1 << 23);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 1 << 23 = truck jump.
 			MstAdd(e_Mst14_RebelSoldier0, (pMst->nPosX >> 8) - 36, (pMst->nPosY >> 8) - 30, (u8 *)&nPrm, -1);
 			pSpe->nNbSoldiers--;
 
 			// 1 fois sur 4, on en fait apparatre 1 en plus  gauche de l'cran.
 			if ((pSpe->nNbSoldiers & 3) == 0)
 			{
-				nPrm = ((u32)pM14[rand() & 3]) | (1 * 4096) | (16 << 17);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 16 << 17, dcalage d'origine de la zone.
+				nPrm = ((u32)pM14[Rnd() & 3]) | (1 * 4096) | (16 << 17);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 16 << 17, dcalage d'origine de la zone.
 				MstAdd(e_Mst14_RebelSoldier0, (gScrollPos.nPosX >> 8) - 24, (pMst->nPosY >> 8), (u8 *)&nPrm, -1);
 			}
 
@@ -2006,8 +2006,8 @@ s32 Mst17_Main_Explosions0(struct SMstCommon *pMst)
 		if (pSpe->nFrames & 1)	// 1 frame sur 2.
 		{
 			s32	nPosX, nPosY;
-			nPosX = pMst->nPosX + ((rand() % (pSpe->nBlkLg * 16)) * 256);
-			nPosY = pMst->nPosY + ((rand() % (pSpe->nBlkHt * 16)) * 256);
+			nPosX = pMst->nPosX + ((Rnd() % (pSpe->nBlkLg * 16)) * 256);
+			nPosY = pMst->nPosY + ((Rnd() % (pSpe->nBlkHt * 16)) * 256);
 
 			// Explosion.
 			DustSet(gAnm_Explosion0_Medium_NoSfx_Dust, nPosX, nPosY, pSpe->nPrio, 0);
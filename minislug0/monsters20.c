@@ -692,7 +692,7 @@ u32 Mst26_Shot(struct SMstCommon *pMst, s32 nDist)
 			DustSet(gAnm_Girida0_Turret_ShotFx_Dust, pMst->nPosX + (nOffsX * 256), pSpe->nPosY + (nOffsY * 256), e_Prio_DustOver, 0);
 		}
 		// Next shot.
-		pSpe->nShotCnt = (rand() & 127) | 32;
+		pSpe->nShotCnt = (Rnd() & 127) | 32;
 		return (1);
 	}
 	return (0);
@@ -1538,7 +1538,7 @@ s32 Mst29_Main_Whale0(struct SMstCommon *pMst)
 		// Dust bubbles.
 		if ((gnFrame & 63) == 0)
 		{
-			DustSetMvt(gAnm_Whale_Bubbles_Dust, pMst->nPosX + ((64 - (rand() & 127)) * 256), pMst->nPosY - (8 * 256), 0, -0x40, e_Prio_Ennemies +32 +1, 0);
+			DustSetMvt(gAnm_Whale_Bubbles_Dust, pMst->nPosX + ((64 - (Rnd() & 127)) * 256), pMst->nPosY - (8 * 256), 0, -0x40, e_Prio_Ennemies +32 +1, 0);
 		}
 		// Dans cette phase, on s'arrte l.
 		return (e_MstState_Managed);
@@ -1597,6 +1597,12 @@ s32 Mst29_Main_Whale0(struct SMstCommon *pMst)
 
 //=============================================================================
 
+// Snapshots : Squences de monstres.
+void Mst20SnapZones(void)
+{
+	SnapZoneAdd(&gMstMisc, sizeof(gMstMisc), NULL, NULL);
+}
+
 /*
 struct SAAC { u8	nTb0[80]; };
 assert(sizeof(struct SAAC) < MST_COMMON_DATA_SZ);
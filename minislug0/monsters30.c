@@ -109,7 +109,7 @@ Type = 0:3: Squid - Piranha
 prm = 4:7:			; tmp.
 */
 				pData[0] = pSpe->nType;
-				MstAdd(e_Mst31_Squid0, (gScrollPos.nPosX >> 8) + SCR_Width + 64, (pMst->nPosY >> 8) + (rand() % ((u32)pSpe->nZoneH * 16)), pData, -1);
+				MstAdd(e_Mst31_Squid0, (gScrollPos.nPosX >> 8) + SCR_Width + 64, (pMst->nPosY >> 8) + (Rnd() % ((u32)pSpe->nZoneH * 16)), pData, -1);
 			}
 			else
 			{
@@ -118,7 +118,7 @@ prm = 4:7:			; tmp.
 Type = 0:3: Small - 	// << mais inutilis�.
 */
 //pData[0] = xxx;	// Rien pour le moment.
-				MstAdd(e_Mst10_Jellyfish, (gScrollPos.nPosX >> 8) + (rand() % (SCR_Width + (SCR_Width/2))), (gScrollPos.nPosY >> 8) + SCR_Height + 16, pData, -1);
+				MstAdd(e_Mst10_Jellyfish, (gScrollPos.nPosX >> 8) + (Rnd() % (SCR_Width + (SCR_Width/2))), (gScrollPos.nPosY >> 8) + SCR_Height + 16, pData, -1);
 			}
 
 			// Reinit compteur.
@@ -407,7 +407,7 @@ prm = 37:39:			; tmp
 
 			if (pSpe->nType == 4)
 			{	// Mars UFO.
-				u32	nRnd = rand();
+				u32	nRnd = Rnd();
 				// On g�n�re les 3 monstres d'un coup.
 				MstAdd(e_Mst41_L11MarsUFO0, (gScrollPos.nPosX >> 8) + SCR_Width + 32, (gScrollPos.nPosY >> 8) + (nRnd & 0x7F), pData, -1);
 				pSpe->nOrder++;
@@ -440,8 +440,8 @@ SeqNo = 0:3:		; No de la s�quence.
 prm = 4:7:			; tmp
 */
 			// Position au hasard.
-//			nPosX = ((rand() % (SCR_Width * 2)) - (SCR_Width / 2)) * 256;
-			nPosX = ((rand() % SCR_Width) + (pSpe->nNb & 1 ? SCR_Width : 0) - (SCR_Width / 2)) * 256;
+//			nPosX = ((Rnd() % (SCR_Width * 2)) - (SCR_Width / 2)) * 256;
+			nPosX = ((Rnd() % SCR_Width) + (pSpe->nNb & 1 ? SCR_Width : 0) - (SCR_Width / 2)) * 256;
 			nPosY = gScrollPos.nPosY - (16 * 256);
 			//
 			pData[0] = pSpe->nSeqNo;
@@ -954,7 +954,7 @@ struct SMst35_L11SpaceRocks0
 // Init d'un caillou.
 void Mst35_sub_NewRock(u32 nIdx)
 {
-	u32	nRnd = rand();
+	u32	nRnd = Rnd();
 
 	gpL11SpaceRocks[nIdx].nPosX = ((nRnd % (SCR_Width * 2)) - (SCR_Width / 2)) * 256;
 	gpL11SpaceRocks[nIdx].nPosY = gScrollPos.nPosY - (10 * 256);
@@ -973,7 +973,7 @@ void Mst35_Init_L11SpaceRocks0(struct SMstCommon *pMst, u8 *pData)
 	for (i = 0; i < L11SPACEROCKS_MAX; i++)
 	{
 		Mst35_sub_NewRock(i);
-		gpL11SpaceRocks[i].nPosY = gScrollPos.nPosY + (((rand() % (SCR_Height + 20)) - 10) * 256);
+		gpL11SpaceRocks[i].nPosY = gScrollPos.nPosY + (((Rnd() % (SCR_Height + 20)) - 10) * 256);
 	}
 	gnL11SpaceRockAngle = 192;	// Par d�faut, vers le bas.
 	pSpe->nReqAngle = gnL11SpaceRockAngle;
@@ -1638,6 +1638,13 @@ s32 Mst39_Main_SensorMine0(struct SMstCommon *pMst)
 
 //=============================================================================
 
+// Snapshots : Cailloux du L11.
+void Mst30SnapZones(void)
+{
+	SnapZoneAdd(gpL11SpaceRocks, sizeof(gpL11SpaceRocks), NULL, NULL);
+	SnapZoneAdd(&gnL11SpaceRockAngle, sizeof(gnL11SpaceRockAngle), NULL, NULL);
+}
+
 /*
 struct SAAD { u8	nTb0[80]; };
 assert(sizeof(struct SAAD) < MST_COMMON_DATA_SZ);
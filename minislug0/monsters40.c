@@ -212,7 +212,7 @@ s32 Mst41_Main_L11MarsUFO0(struct SMstCommon *pMst)
 		if (pSpe->nShotNb == 0)
 		{
 			// On repart sur un angle de 90 orient dans le sens d'arrive.
-			pMst->nAngle = ((rand() & 63) - 32) + (pSpe->nOrder * 64);
+			pMst->nAngle = ((Rnd() & 63) - 32) + (pSpe->nOrder * 64);
 			pMst->nPhase = e_Mst41_GoAway;
 			pMst->nSpd = 0;
 		}
@@ -929,7 +929,7 @@ void Mst46_Sub0_Init(struct SMst46_Sub0 *pSub0)
 	pSub0->nPhase = e_Mst46Sub0_Aim;
 	pSub0->nDisp = 0;
 	pSub0->nAnm = AnmSet(gAnm_RebSoldier_LRAC_Idle, -1);
-	pSub0->nCntWait = (rand() & 127) | 63;//31;
+	pSub0->nCntWait = (Rnd() & 127) | 63;//31;
 
 }
 
@@ -971,7 +971,7 @@ void Mst_SubLRAC0_Main(struct SM46SubPrm *pPrm)
 				pPrm->pSub0->nPhase = e_Mst46Sub0_Shot;
 				nAdd = AnmGetImage(pPrm->pSub0->nAnm);	// Premier GetImage pour dclenchement du tir  la mme frame.
 			}
-			pPrm->pSub0->nCntWait = (rand() & 127) | 63;//31;
+			pPrm->pSub0->nCntWait = (Rnd() & 127) | 63;//31;
 		}
 
 		// Peur pendant les explosions.
@@ -1246,7 +1246,7 @@ s32 Mst46_Main_HairBusterRibert0(struct SMstCommon *pMst)
 
 		// Lcher de mini bombes.
 		if ((++pSpe->nShotFrm & 15) == 0)
-			FireAdd(e_Shot_Enemy_HairBusterRibert_Mine, pMst->nPosX - (60 * 256), pMst->nPosY + (3 * 256), 144 - 8 + (rand() & 15));
+			FireAdd(e_Shot_Enemy_HairBusterRibert_Mine, pMst->nPosX - (60 * 256), pMst->nPosY + (3 * 256), 144 - 8 + (Rnd() & 15));
 		break;
 
 	case e_Mst46_FinalFall:		// Chute finale.
@@ -1330,7 +1330,7 @@ s32 Mst46_Main_HairBusterRibert0(struct SMstCommon *pMst)
 		pSpe->nExplosions--;
 		if (pSpe->nExplosions > MEDIUMEXPLO_ANM_DURATION && (pSpe->nExplosions & 0x7) == 0)
 		{
-			i = rand();
+			i = Rnd();
 			DustSet(gAnm_Explosion0_Medium_Dust, pMst->nPosX + (pSpe->nExplosions & 8 ? -64 * 256 : 0) + ((i & 63) * 256), pMst->nPosY - (40 * 256) + (((i >> 8) & 63) * 256), e_Prio_Ennemies+3, 0);
 
 //if (((pSpe->sFrontC[i].nExplo >> 4) + i) & 1)	// + Dbris 1 fois sur 2.
@@ -1503,7 +1503,7 @@ s32 Mst47_Main_Lev9RocketTop0(struct SMstCommon *pMst)
 				RESERVED2 = 27:31:
 				*/
 				u32	nPrm = (2) | (1 * 4096) | (1 << 14);		// 2 = LRAC / 1 * 4096 = Move / 1 << 14 = Parachute.
-				MstAdd(e_Mst14_RebelSoldier0, (pMst->nPosX >> 8) - ((7 + (rand()& 7)) * 16), (gScrollPos.nPosY >> 8), (u8 *)&nPrm, -1);
+				MstAdd(e_Mst14_RebelSoldier0, (pMst->nPosX >> 8) - ((7 + (Rnd()& 7)) * 16), (gScrollPos.nPosY >> 8), (u8 *)&nPrm, -1);
 				pSpe->nNbSoldiers--;
 			}
 
@@ -1519,7 +1519,7 @@ s32 Mst47_Main_Lev9RocketTop0(struct SMstCommon *pMst)
 		if ((pSpe->nExplo & 7) == 0)
 		{
 			s32	nPosX, nPosY;
-			i = rand();
+			i = Rnd();
 			nPosX = pMst->nPosX + ((-64 + (i & 127)) * 256);
 			i += 64;
 			nPosY = pMst->nPosY + ((-112 + (i & 127)) * 256);
@@ -1712,7 +1712,7 @@ s32 Mst48Sub_Main_L7RockBottom0(struct SMstCommon *pMst)
 		RESERVED2 = 27:31:
 		* /
 		static u8 pM14[] = { 3, 3, 0, 1 };	// Pour gnrer des soldats, sauf LRAC.
-		u32	nPrm = ((u32)pM14[rand() & 3]) | (1 * 4096) | (10 << 17);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 10 << 17 = Dcalage de la zone.
+		u32	nPrm = ((u32)pM14[Rnd() & 3]) | (1 * 4096) | (10 << 17);	// 0 = Rifle - 1 = Mortar - 3 = Grenade / 1 * 4096 = Move / 10 << 17 = Dcalage de la zone.
 		MstAdd(e_Mst14_RebelSoldier0, (gScrollPos.nPosX >> 8) - 32, pMst->nPosY >> 8, (u8 *)&nPrm, -1);
 		pSpe->nCnt2--;
 	}
@@ -2224,7 +2224,7 @@ void Mst48Sub_Init_L2Clouds0(struct SMstCommon *pMst, u8 *pData)
 	u32	i;
 
 	// Init des hauteurs.
-	for (i = 0; i < M48T2_NB; i++) pSpe->nCloudsY[i] = rand() & 127;
+	for (i = 0; i < M48T2_NB; i++) pSpe->nCloudsY[i] = Rnd() & 127;
 	pMst->nPosX = 0;
 
 }
@@ -2243,7 +2243,7 @@ s32 Mst48Sub_Main_L2Clouds0(struct SMstCommon *pMst)
 	for (i = 0; i < M48T2_NB; i++)
 	{
 		nPosX = ((pMst->nPosX >> 8) + (i * (512 / M48T2_NB))) & 0x1FF;
-		if (nPosX == 0) pSpe->nCloudsY[i] = rand() & 127;		// Rinit hauteur.
+		if (nPosX == 0) pSpe->nCloudsY[i] = Rnd() & 127;		// Rinit hauteur.
 		SprDisplay(e_Spr_Lev2_Clouds + (i & 1), (gScrollPos.nPosX >> 8) - 96 + nPosX, (gScrollPos.nPosY >> 8) + 256 - (u32)pSpe->nCloudsY[i], e_Prio_EnnemiesBg + 1);
 	}
 
@@ -2594,8 +2594,8 @@ s32 Mst49_Main_SuspSub0(struct SMstCommon *pMst)
 			RESERVED2 = 27:31:
 			*/
 			static u8 pM14[] = { 0, 1, 3, 3 };
-			u32	nSide = rand() & 1;
-			u32	nPrm = ((u32)pM14[rand() & 3]) | (1 * 4096) | (((nSide ? -11 : 11) & 0x3F) << 17);
+			u32	nSide = Rnd() & 1;
+			u32	nPrm = ((u32)pM14[Rnd() & 3]) | (1 * 4096) | (((nSide ? -11 : 11) & 0x3F) << 17);
 			MstAdd(e_Mst14_RebelSoldier0, (gScrollPos.nPosX >> 8) + (nSide ? SCR_Width + 16 : -16), 10 * 16, (u8 *)&nPrm, -1);
 		}
 		break;
@@ -2640,7 +2640,7 @@ s32 Mst49_Main_SuspSub0(struct SMstCommon *pMst)
 		if (pSpe->nExplosions > MEDIUMEXPLO_ANM_DURATION && (pSpe->nExplosions & 0x7) == 0)
 		{
 			u32	i;
-			i = rand();
+			i = Rnd();
 			DustSet(gAnm_Explosion0_Medium_Dust, pMst->nPosX + (pSpe->nExplosions & 8 ? -32 * 256 : 0) + ((i & 31) * 256), pMst->nPosY + (80 * 256) + (((i >> 8) & 31) * 256),
 				e_Prio_Ennemies + 4 + (((MST49_EXPLO_CNT - pSpe->nExplosions) >> 2) & 0x1F), 0);
 
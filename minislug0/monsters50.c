@@ -926,6 +926,13 @@ if (gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonA]])
 
 //=============================================================================
 
+// Snapshots : Rumi et how to play.
+void Mst50SnapZones(void)
+{
+	SnapZoneAdd(&gRumiGen, sizeof(gRumiGen), NULL, NULL);
+	SnapZoneAdd(&gHTPVar, sizeof(gHTPVar), NULL, NULL);
+}
+
 /*
 struct SAAF { u8	nTb0[80]; };
 assert(sizeof(struct SAAF) < MST_COMMON_DATA_SZ);
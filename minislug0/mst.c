@@ -148,18 +148,55 @@ Font_Print(10, 130, pScore, 0);
 
 }
 
-#ifdef DEBUG_DISP
-void mst_tst_dispnb(u32 nPosY)
+// Nb de slots utiliss (profiler).
+u32 MstSlotsUsedNb(void)
 {
 	u32	i, k;
-	// Compte.
+
 	for (i = 0, k = 0; i < MST_MAX_SLOTS; i++) if (gpMstSlots[i].nUsed) k++;
-	// Affichage.
-	char	pTb[4+8+1] = "MST:00000000";
-	MyItoA(k, pTb);
-	Font_Print(10, nPosY, pTb, 0);
+	return (k);
+}
+
+// Snapshots : Les pointeurs de fonction des slots sont remplacs par le n du monstre dans gpMstTb.
+void Mst_sub_SnapPack(u8 *pBuf)
+{
+	struct SMstCommon	*pMst = (struct SMstCommon *)pBuf;
+	uintptr_t	nMstNo;
+	u32	i;
+
+	for (i = 0; i < MST_MAX_SLOTS; i++, pMst++)
+	{
+		for (nMstNo = 0; nMstNo < e_Mst_MAX; nMstNo++)
+			if (pMst->nUsed && gpMstTb[nMstNo].pFctMain == pMst->pFctMain) break;
+		pMst->pFctInit = NULL;
+		pMst->pFctMain = (s32 (*)(struct SMstCommon *))nMstNo;
+	}
+}
+
+// Snapshots : Pointeurs de fonction depuis le n du monstre.
+void Mst_sub_SnapUnpack(u8 *pBuf)
+{
+	struct SMstCommon	*pMst = (struct SMstCommon *)pBuf;
+	uintptr_t	nMstNo;
+	u32	i;
+
+	for (i = 0; i < MST_MAX_SLOTS; i++, pMst++)
+	{
+		nMstNo = (uintptr_t)pMst->pFctMain;
+		pMst->pFctInit = (nMstNo < e_Mst_MAX ? gpMstTb[nMstNo].pFctInit : NULL);
+		pMst->pFctMain = (nMstNo < e_Mst_MAX ? gpMstTb[nMstNo].pFctMain : NULL);
+	}
+}
+
+// Snapshots : Slots des monstres et compteurs.
+void MstSnapZones(void)
+{
+	SnapZoneAdd(gpMstSlots, sizeof(gpMstSlots), Mst_sub_SnapPack, Mst_sub_SnapUnpack);
+	SnapZoneAdd(&gnMstLastUsed, sizeof(gnMstLastUsed), NULL, NULL);
+	SnapZoneAdd(&gnMstPrio, sizeof(gnMstPrio), NULL, NULL);
+	SnapZoneAdd(gpMstQuestItems, sizeof(gpMstQuestItems), NULL, NULL);
+	SnapZoneAdd(gpnMstCount, sizeof(gpnMstCount), NULL, NULL);
 }
-#endif
 
 
 
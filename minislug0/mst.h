@@ -39,6 +39,8 @@ s32 MstAdd(u32 nMstNo, s32 nPosX, s32 nPosY, u8 *pData, s32 nLoadIdx);
 void MstCheckNewCol(s32 nCol, s32 nPosY, s32 nSens);
 void MstCheckNewLine(s32 nLine, s32 nPosX, s32 nSens);
 u32 MstOnScreenNb(u32 nMstType, s32 nBlkOffset);
+u32 MstSlotsUsedNb(void);
+void MstSnapZones(void);
 
 
 
@@ -0,0 +1,210 @@
+// Prsentation de l'image  l'cran.
+// L'cran du jeu (320x224, 565 ou XRGB8888) est agrandi par les scalers directement dans la destination finale :
+// - Soit la surface de la fentre, dans son format natif.
+// - Soit une texture streaming, si le format de la fentre n'est pas gr par les scalers (ou  la demande, -texture).
+// Les pixels de sortie ne sont crits qu'une fois : Plus de buffer intermdiaire blitt (avec conversion) dans la fentre.
+// Le facteur d'agrandissement est le plus grand entier qui tient dans la sortie, l'image est centre (letterbox).
+// Ecran plus rapide que la logique (> FPS_Default Hz) : Texture + renderer avec vsync, l'image est reprsente  chaque
+// rafrachissement entre deux frames logiques (cf. frame.c).
+
+#include "includes.h"
+
+struct SPresent	gPresent;
+
+// Facteur entier et position de l'image pour une sortie de nOutW x nOutH. Facteur 0 : Sortie trop petite.
+void Present_sub_Geometry(s32 nOutW, s32 nOutH)
+{
+	gPresent.nFactor = MIN(nOutW / SCR_Width, nOutH / SCR_Height);
+	if (gPresent.nFactor > SCALER_FACTOR_MAX) gPresent.nFactor = SCALER_FACTOR_MAX;
+	gPresent.nPosX = (nOutW - (SCR_Width * gPresent.nFactor)) / 2;
+	gPresent.nPosY = (nOutH - (SCR_Height * gPresent.nFactor)) / 2;
+}
+
+// Libre la surface de la fentre (SDL_GetWindowSurface) : La SDL ne permet pas d'avoir en mme temps une surface et
+// un renderer sur la mme fentre.
+void Present_sub_WinSurfRelease(void)
+{
+	gPresent.pWinSurf = NULL;
+#if SDL_VERSION_ATLEAST(2, 28, 0)
+	if (SDL_HasWindowSurface(gVar.pWindow)) SDL_DestroyWindowSurface(gVar.pWindow);
+#else
+	// Pas de SDL_DestroyWindowSurface avant la 2.28 : On recre la fentre,  l'identique.
+	{
+		char	pTitle[64];
+		int	nW, nH;
+		Uint32	nFlags;
+
+		strncpy(pTitle, SDL_GetWindowTitle(gVar.pWindow), sizeof(pTitle) - 1);
+		pTitle[sizeof(pTitle) - 1] = 0;
+		SDL_GetWindowSize(gVar.pWindow, &nW, &nH);
+		nFlags = SDL_GetWindowFlags(gVar.pWindow) & SDL_WINDOW_FULLSCREEN;
+		SDL_DestroyWindow(gVar.pWindow);
+		if ((gVar.pWindow = SDL_CreateWindow(pTitle, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, nW, nH, nFlags)) == NULL)
+		{
+			fprintf(stderr, "Present_sub_WinSurfRelease(): Couldn't create window: %s\n", SDL_GetError());
+			exit(1);
+		}
+	}
+#endif
+}
+
+// Init du backend texture.
+void Present_sub_TextureInit(void)
+{
+	gPresent.nBackend = e_Present_Texture;
+	gPresent.pTexture = NULL;
+	gPresent.nTexFactor = 0;
+	if ((gPresent.pRenderer = SDL_CreateRenderer(gVar.pWindow, -1, SDL_RENDERER_SOFTWARE)) == NULL)
+	{
+		fprintf(stderr, "Present_sub_TextureInit(): SDL_CreateRenderer failed: %s\n", SDL_GetError());
+		exit(1);
+	}
+}
+
+// Init du backend texture avec vsync, si l'cran rafrachit plus vite que la logique. Sinon, rien ne change.
+void Present_sub_VSyncInit(void)
+{
+	SDL_DisplayMode	sMode;
+	SDL_RendererInfo	sInfo;
+
+	if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(gVar.pWindow), &sMode) < 0) return;
+	if (sMode.refresh_rate <= FPS_Default) return;
+	// Renderer acclr : Le renderer soft ne se synchronise pas sur l'cran.
+	if ((gPresent.pRenderer = SDL_CreateRenderer(gVar.pWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)) == NULL) return;
+	if (SDL_GetRendererInfo(gPresent.pRenderer, &sInfo) < 0 || (sInfo.flags & SDL_RENDERER_PRESENTVSYNC) == 0)
+	{
+		SDL_DestroyRenderer(gPresent.pRenderer);
+		gPresent.pRenderer = NULL;
+		return;
+	}
+	gPresent.nBackend = e_Present_Texture;
+	gPresent.nVSync = 1;
+	gPresent.nRefresh = sMode.refresh_rate;
+#ifdef DEBUG_INFO
+printf("PresentInit: vsync, %d Hz (%s).\n", (int)sMode.refresh_rate, sInfo.name);
+#endif
+}
+
+// Init (1 fois !). A faire aprs la cration de la fentre.
+void PresentInit(u32 nBackend, u32 nVSync)
+{
+	memset(&gPresent, 0, sizeof(gPresent));
+	gPresent.nBackend = e_Present_Window;
+	if (nVSync) Present_sub_VSyncInit();
+	if (gPresent.nVSync == 0 && nBackend == e_Present_Texture) Present_sub_TextureInit();
+}
+
+// Nettoyage (1 fois !).
+void PresentRelease(void)
+{
+	if (gPresent.pTexture != NULL) SDL_DestroyTexture(gPresent.pTexture);
+	if (gPresent.pRenderer != NULL) SDL_DestroyRenderer(gPresent.pRenderer);
+	gPresent.pTexture = NULL;
+	gPresent.pRenderer = NULL;
+}
+
+// A appeler quand la fentre change (taille, plein cran).
+void PresentReset(void)
+{
+	gPresent.pWinSurf = NULL;
+}
+
+// Backend fentre. Out : 0 si le format de la fentre n'est pas gr.
+u32 Present_sub_DrawWindow(SDL_Surface *pSrc, u32 nTV)
+{
+	SDL_Surface	*pWin;
+	u32	nBpp;
+
+	pWin = SDL_GetWindowSurface(gVar.pWindow);
+	if (pWin == NULL || ScalerDstFormatOk(pWin->format) == 0) return (0);
+
+	// Changement de gomtrie ? => On efface les bordures.
+	if (pWin != gPresent.pWinSurf || pWin->w != gPresent.nWinW || pWin->h != gPresent.nWinH)
+	{
+		gPresent.pWinSurf = pWin;
+		gPresent.nWinW = pWin->w;
+		gPresent.nWinH = pWin->h;
+		SDL_FillRect(pWin, NULL, 0);
+	}
+	Present_sub_Geometry(pWin->w, pWin->h);
+	if (gPresent.nFactor == 0) return (1);
+
+	nBpp = pWin->format->BytesPerPixel;
+	if (SDL_MUSTLOCK(pWin)) SDL_LockSurface(pWin);
+	ScalerRenderBuf((upix *)pSrc->pixels, pSrc->pitch, pSrc->w, pSrc->h,
+		(u8 *)pWin->pixels + (gPresent.nPosY * pWin->pitch) + (gPresent.nPosX * nBpp), pWin->pitch, nBpp,
+		gPresent.nFactor, nTV);
+	if (SDL_MUSTLOCK(pWin)) SDL_UnlockSurface(pWin);
+	return (1);
+}
+
+// Backend texture.
+void Present_sub_DrawTexture(SDL_Surface *pSrc, u32 nTV)
+{
+	s32	nOutW, nOutH;
+	void	*pPix;
+	int	nPitch;
+
+	if (SDL_GetRendererOutputSize(gPresent.pRenderer, &nOutW, &nOutH) < 0) return;
+	Present_sub_Geometry(nOutW, nOutH);
+	if (gPresent.nFactor == 0) return;
+
+	// Texture  la taille finale, recre si le facteur change.
+	if (gPresent.nFactor != gPresent.nTexFactor)
+	{
+		if (gPresent.pTexture != NULL) SDL_DestroyTexture(gPresent.pTexture);
+		gPresent.pTexture = SDL_CreateTexture(gPresent.pRenderer, SDL_PIXELFORMAT_RGB888, SDL_TEXTUREACCESS_STREAMING,
+			SCR_Width * gPresent.nFactor, SCR_Height * gPresent.nFactor);
+		if (gPresent.pTexture == NULL)
+		{
+			fprintf(stderr, "Present_sub_DrawTexture(): SDL_CreateTexture failed: %s\n", SDL_GetError());
+			exit(1);
+		}
+		gPresent.nTexFactor = gPresent.nFactor;
+	}
+
+	if (SDL_LockTexture(gPresent.pTexture, NULL, &pPix, &nPitch) < 0) return;
+	ScalerRenderBuf((upix *)pSrc->pixels, pSrc->pitch, pSrc->w, pSrc->h, pPix, nPitch, 4, gPresent.nFactor, nTV);
+	SDL_UnlockTexture(gPresent.pTexture);
+}
+
+// Ecriture de l'image de la frame dans la destination finale.
+void PresentDraw(SDL_Surface *pSrc, u32 nTV)
+{
+	if (gPresent.nBackend == e_Present_Window)
+	{
+		if (Present_sub_DrawWindow(pSrc, nTV)) return;
+		// Format de fentre non gr => Passage en texture. La surface de la fentre a t demande, on la libre d'abord.
+		Present_sub_WinSurfRelease();
+		Present_sub_TextureInit();
+#ifdef DEBUG_INFO
+printf("PresentDraw: Window format not supported, switching to texture.\n");
+#endif
+	}
+	Present_sub_DrawTexture(pSrc, nTV);
+}
+
+// Affichage.
+void PresentFlip(void)
+{
+	SDL_Rect	sDst;
+
+	if (gPresent.nBackend == e_Present_Window)
+	{
+		SDL_UpdateWindowSurface(gVar.pWindow);
+		return;
+	}
+
+	SDL_SetRenderDrawColor(gPresent.pRenderer, 0, 0, 0, 255);
+	SDL_RenderClear(gPresent.pRenderer);
+	if (gPresent.pTexture != NULL && gPresent.nFactor)
+	{
+		sDst.x = gPresent.nPosX;
+		sDst.y = gPresent.nPosY;
+		sDst.w = SCR_Width * gPresent.nFactor;
+		sDst.h = SCR_Height * gPresent.nFactor;
+		SDL_RenderCopy(gPresent.pRenderer, gPresent.pTexture, NULL, &sDst);
+	}
+	SDL_RenderPresent(gPresent.pRenderer);
+}
+
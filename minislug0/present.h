@@ -0,0 +1,33 @@
+
+// Backends de prsentation.
+enum
+{
+	e_Present_Window = 0,	// Ecriture directe dans la surface de la fentre (SDL_GetWindowSurface), dans son format.
+	e_Present_Texture,		// Ecriture dans une texture streaming (SDL_LockTexture), renderer soft (ou acclr avec vsync).
+};
+
+struct SPresent
+{
+	u8	nBackend;
+	// Backend fentre.
+	SDL_Surface	*pWinSurf;		// Dernire surface fentre, pour dtecter les changements.
+	s32	nWinW, nWinH;
+	// Backend texture.
+	SDL_Renderer	*pRenderer;
+	SDL_Texture	*pTexture;
+	s32	nTexFactor;			// Facteur de la texture en cours.
+	u8	nVSync;				// 1 = SDL_RenderPresent attend le rafrachissement de l'cran.
+	s32	nRefresh;			// Frquence de l'cran, en Hz (avec nVSync).
+	//
+	s32	nFactor;			// Facteur de la frame en cours.
+	s32	nPosX, nPosY;		// Position de l'image (letterbox).
+};
+extern struct SPresent	gPresent;
+
+// Prototypes.
+void PresentInit(u32 nBackend, u32 nVSync);
+void PresentRelease(void);
+void PresentReset(void);
+void PresentDraw(SDL_Surface *pSrc, u32 nTV);
+void PresentFlip(void);
+
@@ -0,0 +1,362 @@
+// Profiler.
+// Chaque tape de la frame est encadre par PROF_START/PROF_STOP (compteur haute rsolution). En fin de frame, les
+// dures et les compteurs (mst, anims, tirs, sprites, cache) sont rangs dans un buffer circulaire des PROF_FRAMES_NB
+// dernires frames.
+// - F11 : Overlay. Barres empiles des dernires frames (une colonne par frame, une couleur par tape) et p50/p99 de
+//   chaque tape, en s.
+// - Option -prof : Le buffer est crit dans PROF_CSV_FILENAME  la sortie.
+// - Headless : Compte rendu sur toute la partie  la sortie (frames par seconde, percentiles, temps moyen par tape).
+//   Avec -json <fichier>, aussi en JSON sur une ligne (lu par bench/bench.sh).
+// Rien n'est enregistr dans le buffer quand ni l'un ni l'autre n'est actif. Les totaux sont toujours tenus.
+
+#include "includes.h"
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+#define	PROF_STATS_PERIOD	35		// Recalcul des percentiles toutes les x frames (2 fois par seconde).
+#define	PROF_BARS_NB		128		// Nb de frames dans le graphe.
+#define	PROF_BARS_HTMAX		80		// Hauteur max des barres, en pixels.
+#define	PROF_BARS_US		250		// s par pixel.
+#define	PROF_FRAME_US		(1000000 / 70)	// Budget d'une frame.
+
+struct SProf	gProf;
+
+#if PROF_ON == 1
+// Noms des tapes (overlay et entte du CSV). + Total.
+char	*gpProfNames[e_Prof_MAX + 1] = { "PLY", "SCR", "BLK", "FIR", "MST", "DST", "HUD", "SCD", "SPR", "TRN", "SNP", "PRS", "WAI", "TOT" };
+char	*gpProfCntNames[e_ProfCnt_MAX] = { "MST", "ANM", "SHT", "SPR", "SDR", "CMS" };
+// Couleurs des barres (pas l'attente).
+u8	gpProfClr[e_Prof_Wait][3] =
+{
+	{ 255, 255, 0 }, { 0, 160, 255 }, { 0, 96, 160 }, { 255, 128, 0 }, { 255, 0, 0 }, { 160, 128, 96 },
+	{ 255, 255, 255 }, { 0, 255, 0 }, { 255, 0, 255 }, { 128, 128, 128 }, { 255, 160, 192 }, { 0, 255, 255 },
+};
+#endif
+
+// Init (1 fois !).
+void ProfInit(void)
+{
+	memset(&gProf, 0, sizeof(struct SProf));
+	gProf.nFreq = SDL_GetPerformanceFrequency();
+	ProfTotalsReset();
+}
+
+// Nettoyage (1 fois !). Compte rendu et dump CSV si demands.
+void ProfRelease(void)
+{
+#if PROF_ON == 1
+	FILE	*pFile;
+	struct SProfFrame	*pFr;
+	u32	i, j;
+
+	if (gProf.nSummary) ProfSummary();
+	gProf.nSummary = 0;
+
+	if (gProf.nCsv == 0 || gProf.nNb == 0) return;
+	if ((pFile = fopen(PROF_CSV_FILENAME, "w")) == NULL)
+	{
+		fprintf(stderr, "ProfRelease(): Unable to open '%s'.\n", PROF_CSV_FILENAME);
+		return;
+	}
+	fprintf(pFile, "frame;skipped");
+	for (j = 0; j < e_Prof_MAX; j++) fprintf(pFile, ";%s_us", gpProfNames[j]);
+	for (j = 0; j < e_ProfCnt_MAX; j++) fprintf(pFile, ";%s", gpProfCntNames[j]);
+	fprintf(pFile, "\n");
+	// Dans l'ordre, de la plus ancienne  la plus rcente.
+	for (i = 0; i < gProf.nNb; i++)
+	{
+		pFr = &gProf.pFrames[(gProf.nHead + PROF_FRAMES_NB - gProf.nNb + i) % PROF_FRAMES_NB];
+		fprintf(pFile, "%u;%u", (unsigned)pFr->nFrame, (unsigned)pFr->nSkipped);
+		for (j = 0; j < e_Prof_MAX; j++) fprintf(pFile, ";%u", (unsigned)pFr->pnUs[j]);
+		for (j = 0; j < e_ProfCnt_MAX; j++) fprintf(pFile, ";%u", (unsigned)pFr->pnCnt[j]);
+		fprintf(pFile, "\n");
+	}
+	fclose(pFile);
+	gProf.nNb = 0;
+#endif
+}
+
+#if PROF_ON == 1
+// Tri pour les percentiles.
+int Prof_sub_Cmp(const void *p1, const void *p2)
+{
+	u32	n1 = *(u32 *)p1, n2 = *(u32 *)p2;
+	return (n1 < n2 ? -1 : (n1 > n2 ? 1 : 0));
+}
+
+// Percentiles de chaque tape et du total (sans l'attente), sur tout le buffer.
+void Prof_sub_Stats(void)
+{
+	static u32	pnTmp[PROF_FRAMES_NB];
+	struct SProfFrame	*pFr;
+	u32	i, j, k;
+
+	for (j = 0; j <= e_Prof_MAX; j++)
+	{
+		for (i = 0; i < gProf.nNb; i++)
+		{
+			pFr = &gProf.pFrames[(gProf.nHead + PROF_FRAMES_NB - gProf.nNb + i) % PROF_FRAMES_NB];
+			if (j < e_Prof_MAX)
+				pnTmp[i] = pFr->pnUs[j];
+			else
+				for (pnTmp[i] = 0, k = 0; k < e_Prof_Wait; k++) pnTmp[i] += pFr->pnUs[k];	// L'attente est la dernire tape.
+		}
+		qsort(pnTmp, gProf.nNb, sizeof(u32), Prof_sub_Cmp);
+		gProf.pnP50[j] = pnTmp[((gProf.nNb - 1) * 50) / 100];
+		gProf.pnP99[j] = pnTmp[((gProf.nNb - 1) * 99) / 100];
+	}
+}
+#endif
+
+// Fin de frame : Les temps cumuls et les compteurs sont rangs dans le buffer. nSkipped = 1 : Frame sans rendu.
+void ProfFrameEnd(u32 nSkipped)
+{
+#if PROF_ON == 1
+	struct SProfFrame	*pFr;
+	struct SCacheStats	sCache;
+	Uint64	nWork;
+	u32	i;
+
+	// Totaux.
+	for (nWork = 0, i = 0; i < e_Prof_MAX; i++)
+	{
+		gProf.pnTotTicks[i] += gProf.pnAcc[i];
+		if (i != e_Prof_Wait) nWork += gProf.pnAcc[i];
+	}
+	i = (u32)((nWork * 1000000) / gProf.nFreq) / PROF_HISTO_US;
+	gProf.pnHisto[MIN(i, PROF_HISTO_NB - 1)]++;
+	gProf.nTotFrames++;
+	CacheStatsGet(&sCache, NULL);
+	gProf.nTotCacheHits += sCache.nHits;
+	gProf.nTotCacheMisses += sCache.nMisses;
+	gProf.nTotRZHits += sCache.nRZHits;
+	gProf.nTotRZMisses += sCache.nRZMisses;
+
+	if (gProf.nOverlay | gProf.nCsv)
+	{
+		pFr = &gProf.pFrames[gProf.nHead];
+		for (i = 0; i < e_Prof_MAX; i++) pFr->pnUs[i] = (u32)((gProf.pnAcc[i] * 1000000) / gProf.nFreq);
+		pFr->pnCnt[e_ProfCnt_Mst] = MstSlotsUsedNb();
+		pFr->pnCnt[e_ProfCnt_Anm] = AnmSlotsUsedNb();
+		pFr->pnCnt[e_ProfCnt_Shot] = FireSlotsUsedNb();
+		pFr->pnCnt[e_ProfCnt_Spr] = gSprStoStats.nFrameUsed;
+		pFr->pnCnt[e_ProfCnt_SprDrop] = gSprStoStats.nLastFrameDroppedNb;
+		pFr->pnCnt[e_ProfCnt_CacheMiss] = sCache.nMisses + sCache.nRZMisses;
+		pFr->nFrame = gnFrame;
+		pFr->nSkipped = nSkipped;
+		if (++gProf.nHead >= PROF_FRAMES_NB) gProf.nHead = 0;
+		if (gProf.nNb < PROF_FRAMES_NB) gProf.nNb++;
+
+		if (gProf.nOverlay && gProf.nStatsCnt-- == 0)
+		{
+			Prof_sub_Stats();
+			gProf.nStatsCnt = PROF_STATS_PERIOD - 1;
+		}
+	}
+	memset(gProf.pnAcc, 0, sizeof(gProf.pnAcc));
+#endif
+}
+
+// RAZ des totaux (dbut de partie).
+void ProfTotalsReset(void)
+{
+	memset(gProf.pnTotTicks, 0, sizeof(gProf.pnTotTicks));
+	memset(gProf.pnHisto, 0, sizeof(gProf.pnHisto));
+	gProf.nTotFrames = 0;
+	gProf.nTotCacheHits = gProf.nTotCacheMisses = 0;
+	gProf.nTotRZHits = gProf.nTotRZMisses = 0;
+	Sfx_MixStatsGet(&gProf.nMixTicks0, &gProf.nMixCalls0);
+	gProf.nTotStart = SDL_GetPerformanceCounter();
+}
+
+#if PROF_ON == 1
+// Percentile de la dure de frame, d'aprs l'histogramme. En s (haut de la case).
+u32 Prof_sub_HistoPercentile(u32 nPct)
+{
+	u32	i, nCnt, nRank;
+
+	nRank = ((gProf.nTotFrames * nPct) + 99) / 100;		// Rang, arrondi au dessus.
+	for (nCnt = 0, i = 0; i < PROF_HISTO_NB - 1; i++)
+		if ((nCnt += gProf.pnHisto[i]) >= nRank) break;
+	return ((i + 1) * PROF_HISTO_US);
+}
+#endif
+
+#if PROF_ON == 1
+// Pic de mmoire du process, en Ko. 0 si inconnu.
+u32 Prof_sub_PeakMemKb(void)
+{
+#ifdef __linux__
+	struct rusage	sUsage;
+
+	if (getrusage(RUSAGE_SELF, &sUsage) == 0) return ((u32)sUsage.ru_maxrss);	// En Ko sous Linux.
+#endif
+	return (0);
+}
+
+// Taux de hits d'un cache, de 0  1.
+// Note : Avec les spans (SPRSPAN_ON, par dfaut), les sprites normaux sont tracs sans passer par le cache des sprites,
+// il n'a alors aucun accs. Seul le cache des roto/zooms travaille.
+double Prof_sub_HitRate(u32 nHits, u32 nMisses)
+{
+	return (nHits + nMisses ? (double)nHits / (nHits + nMisses) : 0);
+}
+
+// Compte rendu en JSON, sur une ligne.
+void Prof_sub_SummaryJson(double fSec, double fMixUs)
+{
+	FILE	*pFile;
+	u32	i;
+
+	if ((pFile = fopen(gProf.pJsonFilename, "w")) == NULL)
+	{
+		fprintf(stderr, "ProfSummary(): Unable to create '%s'.\n", gProf.pJsonFilename);
+		return;
+	}
+	fprintf(pFile, "{\"frames\":%u,\"seconds\":%.3f,\"fps\":%.1f", (unsigned)gProf.nTotFrames, fSec, fSec > 0 ? gProf.nTotFrames / fSec : 0);
+	fprintf(pFile, ",\"frame_p50_us\":%u,\"frame_p95_us\":%u,\"frame_p99_us\":%u,\"frame_max_us\":%u",
+		(unsigned)Prof_sub_HistoPercentile(50), (unsigned)Prof_sub_HistoPercentile(95),
+		(unsigned)Prof_sub_HistoPercentile(99), (unsigned)Prof_sub_HistoPercentile(100));
+	fprintf(pFile, ",\"peak_mem_kb\":%u", (unsigned)Prof_sub_PeakMemKb());
+	fprintf(pFile, ",\"cache_hit_rate\":%.4f,\"cache_lookups\":%u", Prof_sub_HitRate(gProf.nTotCacheHits, gProf.nTotCacheMisses),
+		(unsigned)(gProf.nTotCacheHits + gProf.nTotCacheMisses));
+	fprintf(pFile, ",\"rz_cache_hit_rate\":%.4f,\"rz_cache_lookups\":%u", Prof_sub_HitRate(gProf.nTotRZHits, gProf.nTotRZMisses),
+		(unsigned)(gProf.nTotRZHits + gProf.nTotRZMisses));
+	fprintf(pFile, ",\"audio_mix_us\":%.1f", fMixUs);
+	fprintf(pFile, ",\"stages_us\":{");
+	for (i = 0; i < e_Prof_MAX; i++)
+		fprintf(pFile, "%s\"%s\":%.1f", i ? "," : "", gpProfNames[i], ((double)gProf.pnTotTicks[i] * 1000000) / gProf.nFreq / gProf.nTotFrames);
+	fprintf(pFile, "}}\n");
+	fclose(pFile);
+}
+#endif
+
+// Compte rendu depuis le dernier RAZ des totaux.
+void ProfSummary(void)
+{
+#if PROF_ON == 1
+	double	fSec, fWork, fMixUs;
+	Uint64	nMixTicks;
+	u32	nMixCalls;
+	u32	i;
+
+	if (gProf.nTotFrames == 0) return;
+	fSec = (double)(SDL_GetPerformanceCounter() - gProf.nTotStart) / gProf.nFreq;
+	for (fWork = 0, i = 0; i < e_Prof_MAX; i++) if (i != e_Prof_Wait) fWork += gProf.pnTotTicks[i];
+	if (fWork == 0) fWork = 1;
+	// Mixer audio : Temps moyen par appel.
+	Sfx_MixStatsGet(&nMixTicks, &nMixCalls);
+	nMixCalls -= gProf.nMixCalls0;
+	fMixUs = (nMixCalls ? ((double)(nMixTicks - gProf.nMixTicks0) * 1000000) / gProf.nFreq / nMixCalls : 0);
+
+	printf("Prof: %d frames in %.2f s, %.1f fps.\n", (int)gProf.nTotFrames, fSec, fSec > 0 ? gProf.nTotFrames / fSec : 0);
+	printf("Prof: Frame (without wait) p50 %d us, p99 %d us, max %d us.\n",
+		(int)Prof_sub_HistoPercentile(50), (int)Prof_sub_HistoPercentile(99), (int)Prof_sub_HistoPercentile(100));
+	for (i = 0; i < e_Prof_MAX; i++)
+		printf("Prof: %s %9.1f us/frame %5.1f %%\n", gpProfNames[i],
+			((double)gProf.pnTotTicks[i] * 1000000) / gProf.nFreq / gProf.nTotFrames,
+			i == e_Prof_Wait ? 0 : (gProf.pnTotTicks[i] * 100) / fWork);
+	printf("Prof: Peak memory %d KB, audio mix %.1f us/call.\n", (int)Prof_sub_PeakMemKb(), fMixUs);
+	printf("Prof: Sprite cache hit rate %.1f %% (%d lookups), rotozoom cache hit rate %.1f %% (%d lookups).\n",
+		100.0 * Prof_sub_HitRate(gProf.nTotCacheHits, gProf.nTotCacheMisses), (int)(gProf.nTotCacheHits + gProf.nTotCacheMisses),
+		100.0 * Prof_sub_HitRate(gProf.nTotRZHits, gProf.nTotRZMisses), (int)(gProf.nTotRZHits + gProf.nTotRZMisses));
+
+	if (gProf.pJsonFilename != NULL) Prof_sub_SummaryJson(fSec, fMixUs);
+#endif
+}
+
+// Overlay on/off.
+void ProfOverlayToggle(void)
+{
+#if PROF_ON == 1
+	gProf.nOverlay ^= 1;
+	if (gProf.nOverlay == 0) return;
+	if (gProf.nCsv == 0) gProf.nHead = gProf.nNb = 0;	// Pas d'enregistrement en cours, on oublie les vieilles frames.
+	gProf.nStatsCnt = 0;
+	memset(gProf.pnP50, 0, sizeof(gProf.pnP50));
+	memset(gProf.pnP99, 0, sizeof(gProf.pnP99));
+#endif
+}
+
+// Overlay : Textes (p50/p99 des tapes, compteurs de la dernire frame). En sprites,  appeler avant le trac des sprites.
+void ProfOverlayPrint(void)
+{
+#if PROF_ON == 1
+	struct SProfFrame	*pFr;
+	u32	i;
+	s32	nPosY;
+
+	if (gProf.nOverlay == 0 || gProf.nNb == 0) return;
+
+	nPosY = 40;
+	Font_Print(4, nPosY, "    P50   P99", 0);
+	for (i = 0; i <= e_Prof_MAX; i++)
+	{
+		char	pTb0[5+1] = "00000";
+		char	pTb1[5+1] = "00000";
+		nPosY += 8;
+		MyItoA(gProf.pnP50[i], pTb0);
+		MyItoA(gProf.pnP99[i], pTb1);
+		Font_Print(4, nPosY, gpProfNames[i], 0);
+		Font_Print(28, nPosY, pTb0, 0);
+		Font_Print(58, nPosY, pTb1, 0);
+	}
+
+	pFr = &gProf.pFrames[(gProf.nHead + PROF_FRAMES_NB - 1) % PROF_FRAMES_NB];
+	nPosY = 40;
+	for (i = 0; i < e_ProfCnt_MAX; i++)
+	{
+		char	pTb[4+5+1] = "XXX:00000";
+		nPosY += 8;
+		memcpy(pTb, gpProfCntNames[i], 3);
+		MyItoA(pFr->pnCnt[i], pTb);
+		Font_Print(100, nPosY, pTb, 0);
+	}
+#endif
+}
+
+// Overlay : Graphe des dernires frames, directement dans l'cran. A appeler avant la fin des tracs de la frame.
+void ProfOverlayDraw(void)
+{
+#if PROF_ON == 1
+	struct SRenderCtx	*pCtx;
+	struct SProfFrame	*pFr;
+	upix	pnClr[e_Prof_Wait];
+	upix	*pScr;
+	upix	nWhite;
+	s32	nPosX0, nPosY0, nHt, nEnd, nBudget;
+	u32	i, j, nBars, nUs;
+
+	if (gProf.nOverlay == 0 || gProf.nNb == 0) return;
+
+	for (j = 0; j < e_Prof_Wait; j++) pnClr[j] = SDL_MapRGB(gVar.pScreen->format, gpProfClr[j][0], gpProfClr[j][1], gpProfClr[j][2]);
+	nWhite = SDL_MapRGB(gVar.pScreen->format, 255, 255, 255);
+
+	pCtx = RCTX();
+	nPosX0 = SCR_Width - PROF_BARS_NB - 8;
+	nPosY0 = SCR_Height - 8;		// Ligne de base.
+	nBars = MIN(gProf.nNb, PROF_BARS_NB);
+
+	// Une colonne par frame, la plus rcente  droite.
+	for (i = 0; i < nBars; i++)
+	{
+		pFr = &gProf.pFrames[(gProf.nHead + PROF_FRAMES_NB - nBars + i) % PROF_FRAMES_NB];
+		pScr = pCtx->pScr + (nPosY0 * pCtx->nScrPitch) + nPosX0 + (PROF_BARS_NB - nBars) + i;
+		nHt = 0;
+		nUs = 0;
+		for (j = 0; j < e_Prof_Wait; j++)
+		{
+			nUs += pFr->pnUs[j];	// Haut de l'tape = temps cumul.
+			nEnd = MIN((s32)(nUs / PROF_BARS_US), PROF_BARS_HTMAX);
+			for (; nHt < nEnd; nHt++, pScr -= pCtx->nScrPitch) *pScr = pnClr[j];
+		}
+	}
+
+	// Budget d'une frame, en pointills.
+	nBudget = PROF_FRAME_US / PROF_BARS_US;
+	pScr = pCtx->pScr + ((nPosY0 - nBudget) * pCtx->nScrPitch) + nPosX0;
+	for (i = 0; i < PROF_BARS_NB; i += 2) pScr[i] = nWhite;
+#endif
+}
+
@@ -0,0 +1,92 @@
+
+// Profiler : Temps de chaque tape de la frame.
+#define	PROF_ON	1	// 1 = Profiler compil (overlay F11, CSV avec -prof) / 0 = Rien, les timers disparaissent.
+
+#define	PROF_FRAMES_NB	1024	// Taille du buffer circulaire, en frames (~15 s  70 Hz).
+#define	PROF_CSV_FILENAME	"prof.csv"	// Dump du buffer circulaire  la sortie (option -prof).
+#define	PROF_HISTO_NB	8192	// Histogramme des dures de frame : Nb de cases.
+#define	PROF_HISTO_US	8		// Histogramme des dures de frame : s par case (la dernire case = au del).
+
+// Etapes mesures.
+enum
+{
+	e_Prof_Plyr = 0,	// Contrle + affichage du joueur.
+	e_Prof_Scroll,		// ScrollManage.
+	e_Prof_BlkAnm,		// AnmBlkManage.
+	e_Prof_Fire,		// Tirs + destructibles.
+	e_Prof_Mst,			// Monstres.
+	e_Prof_Dust,		// Poussires.
+	e_Prof_HUD,			// HUD.
+	e_Prof_ScrDisp,		// Trac des plans de scroll.
+	e_Prof_Spr,			// Trac des sprites.
+	e_Prof_Transit,		// Transitions.
+	e_Prof_Snap,		// Snapshots (rembobinage).
+	e_Prof_Present,		// Scaling + prsentation.
+	e_Prof_Wait,		// Attente de la frame.
+	e_Prof_MAX
+};
+
+// Compteurs (ex DEBUG_DISP).
+enum
+{
+	e_ProfCnt_Mst = 0,		// Monstres.
+	e_ProfCnt_Anm,			// Anims.
+	e_ProfCnt_Shot,			// Tirs.
+	e_ProfCnt_Spr,			// Sprites tracs.
+	e_ProfCnt_SprDrop,		// Sprites perdus.
+	e_ProfCnt_CacheMiss,	// Cache : Blocs dpacks.
+	e_ProfCnt_MAX
+};
+
+struct SProfFrame
+{
+	u32	pnUs[e_Prof_MAX];		// Dure de chaque tape, en s.
+	u32	pnCnt[e_ProfCnt_MAX];
+	u32	nFrame;					// gnFrame.
+	u8	nSkipped;				// 1 = Frame calcule sans rendu (retard).
+};
+
+struct SProf
+{
+	Uint64	pnStart[e_Prof_MAX];	// Dbut de l'tape en cours.
+	Uint64	pnAcc[e_Prof_MAX];		// Ticks cumuls sur la frame en cours (une tape peut tre mesure plusieurs fois).
+	Uint64	nFreq;
+	struct SProfFrame	pFrames[PROF_FRAMES_NB];	// Buffer circulaire.
+	u32	nHead;			// Prochaine frame crite.
+	u32	nNb;			// Nb de frames valides.
+	u32	nStatsCnt;		// Compteur avant le prochain calcul des percentiles.
+	u32	pnP50[e_Prof_MAX + 1], pnP99[e_Prof_MAX + 1];	// Percentiles, en s. + 1 : Total sans l'attente.
+	// Totaux depuis ProfTotalsReset (compte rendu).
+	Uint64	pnTotTicks[e_Prof_MAX];
+	Uint64	nTotStart;		// Compteur au RAZ.
+	u32	nTotFrames;
+	u32	pnHisto[PROF_HISTO_NB];	// Dures de frame (sans l'attente).
+	u32	nTotCacheHits, nTotCacheMisses;		// Cache des sprites (dpack + masque).
+	u32	nTotRZHits, nTotRZMisses;			// Cache des roto/zooms.
+	Uint64	nMixTicks0;		// Mixer audio au RAZ.
+	u32	nMixCalls0;
+	char	*pJsonFilename;	// Compte rendu en JSON (option -json), pour le benchmark.
+	u8	nOverlay;		// Overlay affich ?
+	u8	nCsv;			// Dump CSV  la sortie ?
+	u8	nSummary;		// Compte rendu  la sortie ?
+};
+extern struct SProf	gProf;
+
+#if PROF_ON == 1
+#define	PROF_START(n)	(gProf.pnStart[n] = SDL_GetPerformanceCounter())
+#define	PROF_STOP(n)	(gProf.pnAcc[n] += SDL_GetPerformanceCounter() - gProf.pnStart[n])
+#else
+#define	PROF_START(n)
+#define	PROF_STOP(n)
+#endif
+
+// Prototypes.
+void ProfInit(void);
+void ProfRelease(void);
+void ProfFrameEnd(u32 nSkipped);
+void ProfTotalsReset(void);
+void ProfSummary(void);
+void ProfOverlayToggle(void);
+void ProfOverlayPrint(void);
+void ProfOverlayDraw(void);
+
@@ -0,0 +1,91 @@
+// Contexte de rendu d'une frame.
+// Avant, chaque passe (plans de scroll, sprites, transitions...) faisait son lock/unlock de surface.
+// Maintenant le contexte est ouvert une fois (au premier trac de la frame) et ferm avant la prsentation.
+// Les surfaces qui n'ont pas besoin de lock (surfaces soft, SDL_MUSTLOCK == 0) ne sont jamais lockes.
+
+#include "includes.h"
+
+struct SRenderCtx	gRCtx;
+
+// Init (1 fois !).
+void RCtxInit(void)
+{
+	memset(&gRCtx, 0, sizeof(gRCtx));
+}
+
+// Enregistrement d'un buffer de scroll (NULL pour le retirer).
+void RCtx_ScrollBufSet(u32 nPlane, SDL_Surface *pSurf)
+{
+	RCtx_FrameEnd();		// Pas de changement de surface avec un contexte ouvert.
+	gRCtx.ppScrollSurf[nPlane] = pSurf;
+	gRCtx.ppScroll[nPlane] = NULL;
+}
+
+// Lock d'une surface si ncessaire.
+void RCtx_sub_Lock(SDL_Surface *pSurf)
+{
+	if (pSurf == NULL || SDL_MUSTLOCK(pSurf) == 0) return;
+	if (SDL_LockSurface(pSurf) < 0)
+	{
+		fprintf(stderr, "RCtx_FrameBegin(): SDL_LockSurface failed: %s\n", SDL_GetError());
+		exit(1);
+	}
+	gRCtx.nLocked++;
+}
+
+// Unlock d'une surface si ncessaire.
+void RCtx_sub_Unlock(SDL_Surface *pSurf)
+{
+	if (pSurf == NULL || SDL_MUSTLOCK(pSurf) == 0) return;
+	SDL_UnlockSurface(pSurf);
+}
+
+// Ouverture du contexte. Utiliser la macro RCTX().
+struct SRenderCtx * RCtx_FrameBegin(void)
+{
+	u32	i;
+
+	if (gRCtx.nActive) return (&gRCtx);
+
+	gRCtx.nLocked = 0;
+	// Ecran.
+	gRCtx.pScreen = gVar.pScreen;
+	RCtx_sub_Lock(gRCtx.pScreen);
+	gRCtx.pScr = (upix *)gRCtx.pScreen->pixels;
+	gRCtx.nScrPitch = gRCtx.pScreen->pitch / sizeof(upix);
+	// Buffers de scroll.
+	for (i = 0; i < MAP_PLANES_MAX; i++)
+	{
+		RCtx_sub_Lock(gRCtx.ppScrollSurf[i]);
+		gRCtx.ppScroll[i] = (gRCtx.ppScrollSurf[i] != NULL ? (upix *)gRCtx.ppScrollSurf[i]->pixels : NULL);
+		gRCtx.pnScrollPitch[i] = (gRCtx.ppScrollSurf[i] != NULL ? gRCtx.ppScrollSurf[i]->pitch / sizeof(upix) : 0);
+	}
+
+	gRCtx.nActive = 1;
+	return (&gRCtx);
+}
+
+// Fermeture du contexte. A faire avant la prsentation, et avant de changer de surface cran.
+void RCtx_FrameEnd(void)
+{
+	u32	i;
+
+	if (gRCtx.nActive == 0) return;
+
+	if (gRCtx.nLocked)
+	{
+		RCtx_sub_Unlock(gRCtx.pScreen);
+		for (i = 0; i < MAP_PLANES_MAX; i++)
+			RCtx_sub_Unlock(gRCtx.ppScrollSurf[i]);
+	}
+	gRCtx.nActive = 0;
+	gRCtx.nLocked = 0;
+}
+
+// A appeler avant un SDL_BlitSurface sur une surface du contexte (le blit choue sur une surface locke).
+// Avec des surfaces soft il n'y a rien de lock, le contexte reste ouvert.
+void RCtx_BlitPrepare(void)
+{
+	if (gRCtx.nLocked) RCtx_FrameEnd();
+}
+
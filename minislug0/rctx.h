@@ -0,0 +1,27 @@
+
+// Contexte de rendu d'une frame : les surfaces sont lockes une seule fois par frame, et tous les modules
+// (scroll, sprites, transitions, menus) crivent directement via les pointeurs du contexte.
+
+struct SRenderCtx
+{
+	SDL_Surface	*pScreen;		// Surface cran du contexte.
+	upix	*pScr;					// Pixels de l'cran.
+	s32	nScrPitch;				// Largeur d'une ligne de l'cran, en pixels (s32, cf. bugfix sprites).
+	SDL_Surface	*ppScrollSurf[MAP_PLANES_MAX];	// Buffers de scroll (enregistrs par le module de scroll).
+	upix	*ppScroll[MAP_PLANES_MAX];				// Pixels des buffers de scroll.
+	s32	pnScrollPitch[MAP_PLANES_MAX];			// Largeur d'une ligne des buffers de scroll, en pixels.
+	u8	nActive;				// Contexte ouvert ?
+	u8	nLocked;				// Nb de surfaces rellement lockes (SDL_MUSTLOCK).
+};
+extern struct SRenderCtx	gRCtx;
+
+// Ouverture  la demande : le premier module qui trace dans la frame ouvre le contexte.
+#define	RCTX()	(gRCtx.nActive ? &gRCtx : RCtx_FrameBegin())
+
+// Prototypes.
+void RCtxInit(void);
+void RCtx_ScrollBufSet(u32 nPlane, SDL_Surface *pSurf);
+struct SRenderCtx * RCtx_FrameBegin(void);
+void RCtx_FrameEnd(void);
+void RCtx_BlitPrepare(void);
+
@@ -0,0 +1,497 @@
+// Enregistrement et rejeu des entres d'une partie.
+// Aprs chaque EventHandler en jeu, on enregistre gVar.pKeys, l'tat brut du clavier SDL (gVar.pKeysSDL, lu directement
+// par le jeu) et gVar.nJoystickState. L'entte contient ce qui est choisi dans les menus (type de partie, cheats, crdits,
+// config des touches) et la graine du hasard.
+// En rejeu, les entres sont rinjectes  la place de celles de la SDL. Avec le hasard dterministe (Rnd), la partie
+// rejoue est identique  l'originale. Un contrle (hasard + joueur) est enregistr toutes les REPLAY_CHECK_PERIOD frames
+// pour dtecter les dsynchros, ainsi qu'un hash de l'image trace (gVar.pScreen) quand elle est disponible.
+//
+// Format : Entte (REPLAY_HDR_SZ octets, champs de SReplayHdr dans l'ordre, sans padding).
+// Puis pour chaque frame, les diffrences par rapport  la frame prcdente :
+// - 0x80 | n : n + 1 frames sans changement.
+// - nb (< 0x7F, ou 0x7F + nb sur 16 bits) : nb changements, chacun = code 16 bits + valeur.
+//   code < 0x200 : gVar.pKeys[code] (8 bits) / code & 0x200 : gVar.pKeysSDL[code & 0x1FF] (8 bits).
+//   REPLAY_CODE_JOY : gVar.nJoystickState (16 bits) / REPLAY_CODE_CHECK : contrle (32 bits).
+//   REPLAY_CODE_SCREEN : taille d'un pixel (8 bits) + hash de l'image de la frame prcdente (32 bits).
+// Toutes les valeurs en little endian.
+//
+// Bot (-botrecord <fichier> <mission> <nb frames>) : Enregistre une partie joue par des entres scriptes (avance, tir,
+// saut, vise, grenades, et manoeuvres de dblocage quand le scroll n'avance plus). Invulnrable, vies infinies. S'arrte
+//  la fin de la mission de dpart ou au bout du nb de frames. A lancer avec -headless : Toutes les frames sont traces,
+// l'enregistrement contient donc tous les contrles d'image.
+
+#include "includes.h"
+
+#define	REPLAY_CODE_SDL		0x200
+#define	REPLAY_CODE_JOY		0x7FFF
+#define	REPLAY_CODE_CHECK	0x7FFE
+#define	REPLAY_CODE_SCREEN	0x7FFD
+
+struct SReplay	gReplay;
+
+//=============================================================================
+// Hasard dterministe (remplace rand(), dont la squence dpend de la libc).
+
+u32	gnRndState = 1;
+
+// Init de la graine.
+void RndSeed(u32 nSeed)
+{
+	gnRndState = (nSeed ? nSeed : 0x2545F491);	// L'tat ne doit jamais tre nul.
+}
+
+// Xorshift 32 bits. Renvoie 0  0x7FFFFFFF, comme rand().
+s32 Rnd(void)
+{
+	gnRndState ^= gnRndState << 13;
+	gnRndState ^= gnRndState >> 17;
+	gnRndState ^= gnRndState << 5;
+	return ((s32)(gnRndState & 0x7FFFFFFF));
+}
+
+//=============================================================================
+
+// Contrle de dsynchro.
+u32 Replay_sub_Check(void)
+{
+	return (gnRndState ^ ((u32)gShoot.nPlayerPosX * 31) ^ ((u32)gShoot.nPlayerPosY * 17) ^ (gShoot.nPlayerScore << 7) ^ gnFrame);
+}
+
+// Enregistrement : Ecriture d'une valeur de nBytes octets dans un buffer. Renvoie la taille crite.
+u32 Replay_sub_Put(u8 *pDst, u32 nVal, u32 nBytes)
+{
+	u32	i;
+
+	for (i = 0; i < nBytes; i++, nVal >>= 8) pDst[i] = (u8)nVal;
+	return (nBytes);
+}
+
+// Hash de l'image (FNV-1a, ligne par ligne).
+u32 Replay_sub_ScrHash(void)
+{
+	u8	*pLn;
+	u32	nHash, x, y;
+
+	nHash = 0x811C9DC5;
+	for (y = 0; y < SCR_Height; y++)
+	{
+		pLn = (u8 *)gVar.pScreen->pixels + (y * gVar.pScreen->pitch);
+		for (x = 0; x < SCR_Width * sizeof(upix); x++) nHash = (nHash ^ pLn[x]) * 0x01000193;
+	}
+	return (nHash);
+}
+
+// Enregistrement : Ecriture de l'entte, champ par champ.
+void Replay_sub_HdrWrite(void)
+{
+	u8	pBuf[REPLAY_HDR_SZ];
+	u32	nSz, i;
+
+	memcpy(pBuf, gReplay.sHdr.pMagic, 4);
+	nSz = 4;
+	nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.nVersion, 1);
+	nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.nGame, 1);
+	nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.nCheat, 1);
+	nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.nLevel, 1);
+	nSz += Replay_sub_Put(&pBuf[nSz], (u8)gReplay.sHdr.nCredits, 1);
+	nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.nSeed, 4);
+	for (i = 0; i < e_CfgKey_MAX; i++) nSz += Replay_sub_Put(&pBuf[nSz], gReplay.sHdr.pCfgKeys[i], 2);
+	fwrite(pBuf, 1, nSz, gReplay.pFile);
+}
+
+// Enregistrement : Ecriture des frames sans changement en attente.
+void Replay_sub_IdleFlush(void)
+{
+	u32	n;
+
+	while (gReplay.nIdle)
+	{
+		n = MIN(gReplay.nIdle, 128);
+		fputc(0x80 | (n - 1), gReplay.pFile);
+		gReplay.nIdle -= n;
+	}
+}
+
+// Enregistrement d'une frame.
+void Replay_sub_RecFrame(void)
+{
+	u8	pChg[(SDL_NUM_SCANCODES * 2 * 3) + (2 + 2) + (2 + 4) + (2 + 1 + 4)];
+	u8	pHdr[3];
+	u32	nNb, nSz, i;
+
+	nNb = nSz = 0;
+	for (i = 0; i < SDL_NUM_SCANCODES; i++)
+	{
+		if (gVar.pKeys[i] != gReplay.pKeys[i])
+		{
+			gReplay.pKeys[i] = gVar.pKeys[i];
+			nSz += Replay_sub_Put(&pChg[nSz], i, 2);
+			pChg[nSz++] = gVar.pKeys[i];
+			nNb++;
+		}
+		if (gVar.pKeysSDL[i] != gReplay.pKeysSDL[i])
+		{
+			gReplay.pKeysSDL[i] = gVar.pKeysSDL[i];
+			nSz += Replay_sub_Put(&pChg[nSz], REPLAY_CODE_SDL | i, 2);
+			pChg[nSz++] = gVar.pKeysSDL[i];
+			nNb++;
+		}
+	}
+	if (gVar.nJoystickState != gReplay.nJoystickState)
+	{
+		gReplay.nJoystickState = gVar.nJoystickState;
+		nSz += Replay_sub_Put(&pChg[nSz], REPLAY_CODE_JOY, 2);
+		nSz += Replay_sub_Put(&pChg[nSz], gVar.nJoystickState, 2);
+		nNb++;
+	}
+	if ((gReplay.nFrames % REPLAY_CHECK_PERIOD) == 0)
+	{
+		nSz += Replay_sub_Put(&pChg[nSz], REPLAY_CODE_CHECK, 2);
+		nSz += Replay_sub_Put(&pChg[nSz], Replay_sub_Check(), 4);
+		nNb++;
+	}
+	if (gReplay.nScrValid)
+	{
+		nSz += Replay_sub_Put(&pChg[nSz], REPLAY_CODE_SCREEN, 2);
+		nSz += Replay_sub_Put(&pChg[nSz], sizeof(upix), 1);
+		nSz += Replay_sub_Put(&pChg[nSz], gReplay.nScrHash, 4);
+		nNb++;
+	}
+	gReplay.nFrames++;
+
+	// Pas de changement ?
+	if (nNb == 0)
+	{
+		gReplay.nIdle++;
+		return;
+	}
+	Replay_sub_IdleFlush();
+	if (nNb < 0x7F)
+		fputc(nNb, gReplay.pFile);
+	else
+	{
+		pHdr[0] = 0x7F;
+		Replay_sub_Put(&pHdr[1], nNb, 2);
+		fwrite(pHdr, 1, 3, gReplay.pFile);
+	}
+	fwrite(pChg, 1, nSz, gReplay.pFile);
+}
+
+//=============================================================================
+// Bot.
+
+// Entres scriptes d'une frame. Ne dpend que du n de frame et de l'tat du jeu : L'enregistrement est reproductible.
+void Replay_sub_BotFrame(void)
+{
+	u32	nFr = gReplay.nFrames;
+	u32	nUp, nDown, nLeft, nRight, nFire, nJump, nBomb, nPhase;
+
+	// Progression : Le scroll a boug de plus de 16 pixels depuis la dernire rfrence (positions en 8.8).
+	if (ABS(gScrollPos.nPosX - gReplay.nBotRefX) > (16 << 8) || ABS(gScrollPos.nPosY - gReplay.nBotRefY) > (16 << 8))
+	{
+		gReplay.nBotRefX = gScrollPos.nPosX;
+		gReplay.nBotRefY = gScrollPos.nPosY;
+		gReplay.nBotStuck = 0;
+	}
+	else
+		gReplay.nBotStuck++;
+
+	// Par dfaut : On avance en tirant, saut rgulier, vise en haut de temps en temps, une grenade de temps en temps.
+	nRight = 1;
+	nLeft = 0;
+	nUp = ((nFr & 255) >= 160 && (nFr & 255) < 200);
+	nDown = 0;
+	nFire = ((nFr & 1) == 0);
+	nJump = ((nFr & 63) == 0);
+	nBomb = ((nFr % 180) == 90);
+
+	// Bloqu (boss, mur, plateforme, niveau vertical...) : Manoeuvres de dblocage,  tour de rle.
+	if (gReplay.nBotStuck > 120)
+	{
+		nPhase = (gReplay.nBotStuck / 60) & 7;
+		nJump = ((nFr & 15) == 0);
+		switch (nPhase)
+		{
+		case 1: nUp = 1; break;					// Monte (nage, hlico, chelles), tir en haut.
+		case 3: nDown = 1; nUp = 0; break;		// Descend (plateformes, nage).
+		case 5: nRight = 0; nLeft = 1; break;	// Recule.
+		case 6: nUp = 1; nJump = 0; break;
+		case 7: nDown = 1; nUp = 0; nJump = 0; break;
+		}
+	}
+
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Up]] = gReplay.pBotKeysSDL[gMSCfg.pKeys[e_CfgKey_Up]] = nUp;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Down]] = gReplay.pBotKeysSDL[gMSCfg.pKeys[e_CfgKey_Down]] = nDown;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Left]] = gReplay.pBotKeysSDL[gMSCfg.pKeys[e_CfgKey_Left]] = nLeft;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_Right]] = gReplay.pBotKeysSDL[gMSCfg.pKeys[e_CfgKey_Right]] = nRight;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonA]] = nFire;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonB]] = nJump;
+	gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonC]] = nBomb;
+}
+
+// Bot : Fin de l'enregistrement et sortie.
+void Replay_sub_BotEnd(void)
+{
+	Replay_sub_IdleFlush();
+	fclose(gReplay.pFile);
+	printf("Replay: %d frames recorded (bot, mission %d, %s).\n", (int)gReplay.nFrames, (int)gReplay.nBotLevel,
+		(gGameVar.nGenLevel != MISSIONOFFS_LEVELS + gReplay.nBotLevel ? "completed" : "frame limit"));
+	exit(0);
+}
+
+//=============================================================================
+
+// Rejeu : Fin. Compte rendu et sortie.
+void Replay_sub_End(void)
+{
+	printf("Replay: %d frames, %d desync(s), %d/%d screen(s) differ.\n", (int)gReplay.nFrames, (int)gReplay.nDesync,
+		(int)gReplay.nScrDesync, (int)gReplay.nScrChecks);
+	free(gReplay.pBuf);
+	gReplay.pBuf = NULL;
+	gReplay.nActive = 0;
+	exit(gReplay.nDesync || gReplay.nScrDesync ? 1 : 0);
+}
+
+// Rejeu : Lecture d'une valeur de nBytes octets. Fin du fichier => Fin du rejeu.
+u32 Replay_sub_Get(u32 nBytes)
+{
+	u32	nVal, i;
+
+	if (gReplay.nBufIdx + nBytes > gReplay.nBufSz) Replay_sub_End();
+	for (nVal = 0, i = 0; i < nBytes; i++) nVal |= (u32)gReplay.pBuf[gReplay.nBufIdx++] << (i * 8);
+	return (nVal);
+}
+
+// Rejeu d'une frame.
+void Replay_sub_PlayFrame(void)
+{
+	u32	nNb, nCode, nVal, nPixSz;
+
+	if (gReplay.nIdle)
+		gReplay.nIdle--;
+	else
+	{
+		nNb = Replay_sub_Get(1);
+		if (nNb & 0x80)
+			gReplay.nIdle = nNb & 0x7F;		// Celle-ci + n frames.
+		else
+		{
+			if (nNb == 0x7F) nNb = Replay_sub_Get(2);
+			while (nNb--)
+			{
+				nCode = Replay_sub_Get(2);
+				if (nCode == REPLAY_CODE_JOY)
+					gReplay.nJoystickState = Replay_sub_Get(2);
+				else if (nCode == REPLAY_CODE_CHECK)
+				{
+					nVal = Replay_sub_Get(4);
+					if (nVal != Replay_sub_Check() && gReplay.nDesync++ == 0)
+						fprintf(stderr, "Replay: Desync at frame %d.\n", (int)gReplay.nFrames);	// Message seulement la premire fois.
+				}
+				else if (nCode == REPLAY_CODE_SCREEN)
+				{
+					// Image compare seulement si elle a t trace ici aussi (pas avec -noraster), au mme format.
+					nPixSz = Replay_sub_Get(1);
+					nVal = Replay_sub_Get(4);
+					if (gReplay.nScrValid && nPixSz == sizeof(upix))
+					{
+						gReplay.nScrChecks++;
+						if (nVal != gReplay.nScrHash && gReplay.nScrDesync++ == 0)
+							fprintf(stderr, "Replay: Screen differs at frame %d.\n", (int)gReplay.nFrames - 1);
+					}
+				}
+				else if (nCode < REPLAY_CODE_SDL)
+					gReplay.pKeys[nCode] = Replay_sub_Get(1);
+				else if (nCode < REPLAY_CODE_SDL + SDL_NUM_SCANCODES)
+					gReplay.pKeysSDL[nCode - REPLAY_CODE_SDL] = Replay_sub_Get(1);
+				else
+				{
+					fprintf(stderr, "Replay_sub_PlayFrame(): Bad code %X at offset %d.\n", (int)nCode, (int)gReplay.nBufIdx - 2);
+					exit(1);
+				}
+			}
+		}
+	}
+	memcpy(gVar.pKeys, gReplay.pKeys, SDL_NUM_SCANCODES);
+	gVar.nJoystickState = gReplay.nJoystickState;
+	gReplay.nFrames++;
+}
+
+// Enregistrement de la prochaine partie (ligne de commande).
+void ReplayRecordSet(char *pFilename)
+{
+	if ((gReplay.pFile = fopen(pFilename, "wb")) == NULL)
+	{
+		fprintf(stderr, "ReplayRecordSet(): Unable to create '%s'.\n", pFilename);
+		exit(1);
+	}
+	gReplay.nMode = e_Replay_Record;
+}
+
+// Rejeu d'une partie (ligne de commande). Le fichier est lu en entier.
+void ReplayPlaySet(char *pFilename)
+{
+	FILE	*pFile;
+	s32	nSz;
+	u32	i;
+
+	if ((pFile = fopen(pFilename, "rb")) == NULL)
+	{
+		fprintf(stderr, "ReplayPlaySet(): Unable to open '%s'.\n", pFilename);
+		exit(1);
+	}
+	fseek(pFile, 0, SEEK_END);
+	nSz = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+	if (nSz < REPLAY_HDR_SZ || (gReplay.pBuf = (u8 *)malloc(nSz)) == NULL ||
+		fread(gReplay.pBuf, 1, nSz, pFile) != (size_t)nSz)
+	{
+		fprintf(stderr, "ReplayPlaySet(): Error reading '%s'.\n", pFilename);
+		exit(1);
+	}
+	fclose(pFile);
+
+	gReplay.nBufSz = nSz;
+	gReplay.nBufIdx = 4;
+	memcpy(gReplay.sHdr.pMagic, gReplay.pBuf, 4);
+	gReplay.sHdr.nVersion = Replay_sub_Get(1);
+	gReplay.sHdr.nGame = Replay_sub_Get(1);
+	gReplay.sHdr.nCheat = Replay_sub_Get(1);
+	gReplay.sHdr.nLevel = Replay_sub_Get(1);
+	gReplay.sHdr.nCredits = (s8)Replay_sub_Get(1);
+	gReplay.sHdr.nSeed = Replay_sub_Get(4);
+	for (i = 0; i < e_CfgKey_MAX; i++) gReplay.sHdr.pCfgKeys[i] = Replay_sub_Get(2);
+	if (strncmp(gReplay.sHdr.pMagic, "MSRP", 4) != 0 || gReplay.sHdr.nVersion != REPLAY_VERSION)
+	{
+		fprintf(stderr, "ReplayPlaySet(): '%s' is not a replay file (or bad version).\n", pFilename);
+		exit(1);
+	}
+	gReplay.nMode = e_Replay_Play;
+}
+
+// Enregistrement par le bot (ligne de commande). nLevel : Mission, comme le level slecteur (0 = M1-1).
+void ReplayBotSet(char *pFilename, u32 nLevel, u32 nFrames)
+{
+	u32	i;
+
+	for (i = 0; i <= nLevel; i++)
+		if (gMissionTb[MISSIONOFFS_LEVELS + i].nLevelNo < 0)
+		{
+			fprintf(stderr, "ReplayBotSet(): Bad mission %d.\n", (int)nLevel);
+			exit(1);
+		}
+	ReplayRecordSet(pFilename);
+	gReplay.nBot = 1;
+	gReplay.nBotLevel = nLevel;
+	gReplay.nBotFrames = nFrames;
+}
+
+// Dbut d'une partie (MENU_Game / MENU_Roguelike). A appeler avant l'init du jeu.
+void ReplayGameStart(u32 nGame)
+{
+	if (gReplay.nMode == e_Replay_Off) return;
+
+	memset(gReplay.pKeys, 0, sizeof(gReplay.pKeys));
+	memset(gReplay.pKeysSDL, 0, sizeof(gReplay.pKeysSDL));
+	gReplay.nJoystickState = 0;
+	gReplay.nFrames = 0;
+	gReplay.nIdle = 0;
+	gReplay.nDesync = 0;
+	gReplay.nScrPending = gReplay.nScrValid = 0;
+	gReplay.nScrChecks = gReplay.nScrDesync = 0;
+
+	if (gReplay.nMode == e_Replay_Record)
+	{
+		if (gReplay.nBot)
+		{
+			// Bot : Level slecteur, invulnrable, vies infinies. Clavier SDL simul.
+			gCCodes.nCheat = e_Cheat_LevelSelect | e_Cheat_Invulnerability | e_Cheat_InfiniteLives;
+			gCCodes.nLevel = gReplay.nBotLevel;
+			gVar.nCreditsToUse = 3;
+			memset(gReplay.pBotKeysSDL, 0, sizeof(gReplay.pBotKeysSDL));
+			gVar.pKeysSDL = gReplay.pBotKeysSDL;
+			gReplay.nBotRefX = gReplay.nBotRefY = 0;
+			gReplay.nBotStuck = 0;
+		}
+		memcpy(gReplay.sHdr.pMagic, "MSRP", 4);
+		gReplay.sHdr.nVersion = REPLAY_VERSION;
+		gReplay.sHdr.nGame = nGame;
+		gReplay.sHdr.nCheat = gCCodes.nCheat;
+		gReplay.sHdr.nLevel = gCCodes.nLevel;
+		gReplay.sHdr.nCredits = gVar.nCreditsToUse;
+		gReplay.sHdr.nSeed = (gReplay.nBot ? 1 + gReplay.nBotLevel : (u32)time(NULL));	// Bot : Reproductible.
+		memcpy(gReplay.sHdr.pCfgKeys, gMSCfg.pKeys, sizeof(gReplay.sHdr.pCfgKeys));
+		Replay_sub_HdrWrite();
+	}
+	else
+	{
+		// Rejeu : Rglages de la partie enregistre, clavier SDL simul.
+		gCCodes.nCheat = gReplay.sHdr.nCheat;
+		gCCodes.nLevel = gReplay.sHdr.nLevel;
+		gVar.nCreditsToUse = gReplay.sHdr.nCredits;
+		memcpy(gMSCfg.pKeys, gReplay.sHdr.pCfgKeys, sizeof(gReplay.sHdr.pCfgKeys));
+		gVar.pKeysSDL = gReplay.pKeysSDL;
+	}
+
+	gnFrame = 0;		// Utilis par la logique du jeu.
+	gReplay.nActive = 1;
+	ProfTotalsReset();
+}
+
+// Fin de la partie. Une seule partie est enregistre.
+void ReplayGameEnd(void)
+{
+	if (gReplay.nActive == 0) return;
+
+	if (gReplay.nMode == e_Replay_Play)
+	{
+		if (gReplay.nIdle || gReplay.nBufIdx < gReplay.nBufSz)
+			fprintf(stderr, "Replay: Game ended before the end of the recording.\n");
+		Replay_sub_End();
+	}
+	if (gReplay.nBot) Replay_sub_BotEnd();
+
+	Replay_sub_IdleFlush();
+	fclose(gReplay.pFile);
+	gReplay.pFile = NULL;
+	gReplay.nActive = 0;
+	gReplay.nMode = e_Replay_Off;
+	printf("Replay: %d frames recorded.\n", (int)gReplay.nFrames);
+}
+
+// Entres d'une frame de jeu. A appeler aprs la lecture des vnements.
+void ReplayFrame(void)
+{
+	if (gReplay.nActive == 0) return;
+
+	if (gReplay.nMode == e_Replay_Record)
+	{
+		if (gReplay.nBot)
+		{
+			// Bot : Fin de la mission ou nb de frames atteint ?
+			if (gReplay.nFrames >= gReplay.nBotFrames || gGameVar.nGenLevel != MISSIONOFFS_LEVELS + gReplay.nBotLevel)
+				Replay_sub_BotEnd();
+			Replay_sub_BotFrame();
+		}
+		Replay_sub_RecFrame();
+	}
+	else
+		Replay_sub_PlayFrame();
+
+	// Le hash de la frame prcdente a t utilis. Frame de contrle => Hash  prendre au rendu.
+	gReplay.nScrValid = 0;
+	gReplay.nScrPending = (((gReplay.nFrames - 1) % REPLAY_CHECK_PERIOD) == 0);
+}
+
+// Contrle de l'image,  appeler au rendu d'une frame (frame trace, avant l'overlay du profiler).
+// Seul le premier rendu aprs la frame de contrle compte (pas ceux de la pause).
+void ReplayScreen(void)
+{
+	if (gReplay.nActive == 0 || gReplay.nScrPending == 0) return;
+
+	gReplay.nScrPending = 0;
+	if (gProf.nOverlay) return;
+	gReplay.nScrHash = Replay_sub_ScrHash();
+	gReplay.nScrValid = 1;
+}
+
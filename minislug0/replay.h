@@ -0,0 +1,69 @@
+
+// Enregistrement / rejeu des entres d'une partie.
+#define	REPLAY_VERSION	1
+#define	REPLAY_CHECK_PERIOD	64		// Contrle de dsynchro toutes les x frames.
+#define	REPLAY_HDR_SZ	(4 + 5 + 4 + (e_CfgKey_MAX * 2))	// Taille de l'entte dans le fichier (crit champ par champ).
+
+enum
+{
+	e_Replay_Off = 0,
+	e_Replay_Record,		// -record <fichier> : La prochaine partie est enregistre.
+	e_Replay_Play,			// -replay <fichier> : On rejoue la partie enregistre, puis on quitte.
+};
+
+struct SReplayHdr
+{
+	char	pMagic[4];		// "MSRP".
+	u8	nVersion;
+	u8	nGame;				// MENU_Game / MENU_Roguelike.
+	u8	nCheat;				// Cheat codes.
+	u8	nLevel;				// Level slecteur.
+	s8	nCredits;			// Nb de crdits.
+	u32	nSeed;				// Graine du hasard.
+	u16	pCfgKeys[e_CfgKey_MAX];	// Config des touches.
+};
+
+struct SReplay
+{
+	u8	nMode;				// e_Replay_...
+	u8	nActive;			// Partie en cours d'enregistrement / de rejeu.
+	struct SReplayHdr	sHdr;
+	// Etat de la frame prcdente (les frames sont codes en diffrence).
+	u8	pKeys[SDL_NUM_SCANCODES];
+	u8	pKeysSDL[SDL_NUM_SCANCODES];
+	u16	nJoystickState;
+	u32	nFrames;			// Nb de frames enregistres / rejoues.
+	u32	nIdle;				// Nb de frames sans changement (en attente d'criture / restant  rejouer).
+	u32	nDesync;			// Nb de contrles rats.
+	// Contrle de l'image (hash de gVar.pScreen, pris au rendu de la frame de contrle).
+	u8	nScrPending;		// Frame de contrle en cours, hash  prendre au prochain rendu.
+	u8	nScrValid;			// Hash de la frame prcdente disponible (frame trace, sans l'overlay).
+	u32	nScrHash;
+	u32	nScrChecks;			// Rejeu : Nb d'images contrles.
+	u32	nScrDesync;			// Rejeu : Nb d'images diffrentes.
+	// Bot (-botrecord) : Enregistrement d'entres scriptes, sans joueur (corpus du benchmark).
+	u8	nBot;
+	u8	nBotLevel;			// Mission de dpart (level slecteur). L'enregistrement s'arrte  la fin de cette mission.
+	u32	nBotFrames;			// Nb max de frames enregistres.
+	s32	nBotRefX, nBotRefY;	// Position du scroll  la dernire progression.
+	u32	nBotStuck;			// Nb de frames sans progression.
+	u8	pBotKeysSDL[SDL_NUM_SCANCODES];	// Clavier SDL simul.
+	// Enregistrement.
+	FILE	*pFile;
+	// Rejeu.
+	u8	*pBuf;
+	u32	nBufSz, nBufIdx;
+};
+extern struct SReplay	gReplay;
+
+// Prototypes.
+void ReplayRecordSet(char *pFilename);
+void ReplayPlaySet(char *pFilename);
+void ReplayBotSet(char *pFilename, u32 nLevel, u32 nFrames);
+void ReplayGameStart(u32 nGame);
+void ReplayGameEnd(void);
+void ReplayFrame(void);
+void ReplayScreen(void);
+void RndSeed(u32 nSeed);
+s32 Rnd(void);
+
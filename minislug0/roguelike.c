@@ -333,7 +333,7 @@ u32 Roguelike_GetSpawnPosX(void)
     
     // Spawn off-screen to the left or right
     s32 nSpawnX;
-    if (rand() % 2 == 0)
+    if (Rnd() % 2 == 0)
     {
         // Spawn to the right of screen
         nSpawnX = nScrollX + SCR_Width + 32;
@@ -379,7 +379,7 @@ u32 Roguelike_GetRandomMonster(u8 nDifficulty)
         break;
     }
     
-    return pPool[rand() % nPoolSize];
+    return pPool[Rnd() % nPoolSize];
 }
 
 // Spawn a random monster
@@ -448,7 +448,7 @@ void Roguelike_DropItem(void)
 void Roguelike_DropWeaponCapsule(void)
 {
     // Random weapon (not gun)
-    u32 nWeapon = (rand() % (e_Player_Weapon_Max - 1)) + 1;
+    u32 nWeapon = (Rnd() % (e_Player_Weapon_Max - 1)) + 1;
     Player_WeaponSet(nWeapon);
 }
 
@@ -739,7 +739,7 @@ void Roguelike_InitPerkSelection(void)
     // Generate 3 unique random perks
     for (int i = 0; i < 3; i++)
     {
-        gRogue.nOfferedPerks[i] = rand() % e_Perk_MAX;
+        gRogue.nOfferedPerks[i] = Rnd() % e_Perk_MAX;
     }
 }
 
@@ -893,6 +893,9 @@ void RoguelikeGame(void)
     Roguelike_Exit();
     Music_Start(e_YmMusic_NoMusic, 1);
     
+    // Replay: no game over screen, ReplayGameEnd reports and quits.
+    if (gReplay.nMode == e_Replay_Play) return;
+
     // Show Game Over screen with roguelike stats
     if (gGameVar.nExitCode != e_Game_Aborted)
     {
@@ -988,7 +991,7 @@ void Roguelike_GameOverWait(void)
     
     while (1)
     {
-        FrameWait();
+        // No FrameWait here: RenderFlip(1) waits (profiler WAI stage) and ends the profiler frame.
         EventHandler(1);
         
         if (gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonA]] || gVar.pKeys[SDL_SCANCODE_RETURN]) break;
@@ -1018,7 +1021,7 @@ void Roguelike_ShowLeaderboardLoop(void)
     
     while (1)
     {
-        FrameWait();
+        // No FrameWait here: RenderFlip(1) waits (profiler WAI stage) and ends the profiler frame.
         EventHandler(1);
         
         if (gVar.pKeys[gMSCfg.pKeys[e_CfgKey_ButtonA]] || 
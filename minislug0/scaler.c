@@ -0,0 +1,626 @@
+// Scalers du rendu (x2, x3, x4, normal ou TV), de l'cran du jeu (565, ou XRGB8888 avec FB32_ON) vers la surface de sortie 16 ou 32 bits.
+// Chaque ligne source est convertie et agrandie une fois par une routine vectorise, les lignes suivantes sont des copies.
+// En mode TV, la premire moiti des lignes est normale, la seconde assombrie.
+// Les lignes sont rparties en bandes entre plusieurs threads.
+
+#include "includes.h"
+
+#if SCALERSIMD_ON == 1
+	#if defined(__wasm_simd128__)
+		#include <wasm_simd128.h>
+		#define	SCALERSIMD_WASM	1
+	#elif defined(__SSE2__) || defined(_M_X64)
+		#include <emmintrin.h>
+		#define	SCALERSIMD_SSE2	1
+	#endif
+#endif
+
+pScalerLn	gpScalerLn16;		// Destination 16 bits.
+pScalerLn	gpScalerLn32;		// Destination 32 bits.
+
+// Tables par composante (la conversion est sparable) : [0] = normal / [1] = assombri (TV).
+u16	gppScalerTV16R[32], gppScalerTV16G[64], gppScalerTV16B[32];		// 565 > 565 assombri.
+u32	gppScaler32R[2][32], gppScaler32G[2][64], gppScaler32B[2][32];	// 565 > XRGB8888.
+
+// Composante 5 ou 6 bits > 8 bits, comme SDL_GetRGB (rplication des bits de poids fort).
+#define	SCALER_EXP5(v)	(((v) << 3) | ((v) >> 2))
+#define	SCALER_EXP6(v)	(((v) << 2) | ((v) >> 4))
+#define	SCALER_TV(v)	(((v) * SCALER_TV_FACTOR) >> 8)
+
+// Calcul des tables par composante, avec la SDL.
+// Out : 1 si la SDL donne les mmes valeurs que les calculs des routines SIMD, 0 sinon.
+u32 Scaler_sub_CalculateTables(void)
+{
+	SDL_PixelFormat	*pFmt16, *pFmt32;
+	u32	i, nTV, nSame;
+	u8	r, g, b;
+
+	pFmt16 = SDL_AllocFormat(SDL_PIXELFORMAT_RGB565);
+	pFmt32 = SDL_AllocFormat(SDL_PIXELFORMAT_RGB888);
+	if (pFmt16 == NULL || pFmt32 == NULL)
+	{
+		fprintf(stderr, "Scaler_sub_CalculateTables(): SDL_AllocFormat failed: %s\n", SDL_GetError());
+		exit(1);
+	}
+
+	nSame = 1;
+	for (i = 0; i < 64; i++)
+	for (nTV = 0; nTV < 2; nTV++)
+	{
+		// Les 3 composantes en mme temps : r et b sur 5 bits (i & 31), g sur 6 bits.
+		SDL_GetRGB(((i & 31) << 11) | (i << 5) | (i & 31), pFmt16, &r, &g, &b);
+		if (r != SCALER_EXP5(i & 31) || g != SCALER_EXP6(i) || b != SCALER_EXP5(i & 31)) nSame = 0;
+		if (nTV)
+		{
+			r = SCALER_TV((u32)r);
+			g = SCALER_TV((u32)g);
+			b = SCALER_TV((u32)b);
+			gppScalerTV16G[i] = SDL_MapRGB(pFmt16, 0, g, 0);
+			if (i < 32)
+			{
+				gppScalerTV16R[i] = SDL_MapRGB(pFmt16, r, 0, 0);
+				gppScalerTV16B[i] = SDL_MapRGB(pFmt16, 0, 0, b);
+				if (gppScalerTV16R[i] != ((u32)r >> 3) << 11 || gppScalerTV16B[i] != (u32)b >> 3) nSame = 0;
+			}
+			if (gppScalerTV16G[i] != ((u32)g >> 2) << 5) nSame = 0;
+		}
+		gppScaler32G[nTV][i] = SDL_MapRGB(pFmt32, 0, g, 0);
+		if ((u32)g << 8 != gppScaler32G[nTV][i]) nSame = 0;
+		if (i < 32)
+		{
+			gppScaler32R[nTV][i] = SDL_MapRGB(pFmt32, r, 0, 0);
+			gppScaler32B[nTV][i] = SDL_MapRGB(pFmt32, 0, 0, b);
+			if ((u32)r << 16 != gppScaler32R[nTV][i] || b != gppScaler32B[nTV][i]) nSame = 0;
+		}
+	}
+
+	SDL_FreeFormat(pFmt16);
+	SDL_FreeFormat(pFmt32);
+	return (nSame);
+}
+
+// Version C, destination 16 bits.
+void ScalerLn16_C(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u16	*pDst2 = (u16 *)pDst;
+	u32	nClr, k;
+
+	for (; nPix; nPix--)
+	{
+		nClr = *pSrc++;
+		if (nTV) nClr = SCALER_TV16(nClr);
+		for (k = nFactor; k; k--) *pDst2++ = nClr;
+	}
+}
+
+// Version C, destination 32 bits.
+void ScalerLn32_C(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	u32	*pR = gppScaler32R[nTV ? 1 : 0];
+	u32	*pG = gppScaler32G[nTV ? 1 : 0];
+	u32	*pB = gppScaler32B[nTV ? 1 : 0];
+	u32	nClr, k;
+
+	for (; nPix; nPix--)
+	{
+		nClr = *pSrc++;
+		nClr = pR[nClr >> 11] | pG[(nClr >> 5) & 0x3F] | pB[nClr & 0x1F];
+		for (k = nFactor; k; k--) *pDst2++ = nClr;
+	}
+}
+
+#ifdef SCALERSIMD_SSE2
+// 8 pixels 565 > composantes 8 bits (comme SDL_GetRGB), assombries pour les lignes TV.
+void Scaler_sub_Split_SSE2(__m128i vClr, u32 nTV, __m128i *pR, __m128i *pG, __m128i *pB)
+{
+	__m128i	vR, vG, vB;
+
+	vR = _mm_srli_epi16(vClr, 11);
+	vG = _mm_and_si128(_mm_srli_epi16(vClr, 5), _mm_set1_epi16(0x3F));
+	vB = _mm_and_si128(vClr, _mm_set1_epi16(0x1F));
+	vR = _mm_or_si128(_mm_slli_epi16(vR, 3), _mm_srli_epi16(vR, 2));
+	vG = _mm_or_si128(_mm_slli_epi16(vG, 2), _mm_srli_epi16(vG, 4));
+	vB = _mm_or_si128(_mm_slli_epi16(vB, 3), _mm_srli_epi16(vB, 2));
+	if (nTV)
+	{
+		vR = _mm_srli_epi16(_mm_mullo_epi16(vR, _mm_set1_epi16(SCALER_TV_FACTOR)), 8);
+		vG = _mm_srli_epi16(_mm_mullo_epi16(vG, _mm_set1_epi16(SCALER_TV_FACTOR)), 8);
+		vB = _mm_srli_epi16(_mm_mullo_epi16(vB, _mm_set1_epi16(SCALER_TV_FACTOR)), 8);
+	}
+	*pR = vR;
+	*pG = vG;
+	*pB = vB;
+}
+
+// SSE2, destination 16 bits, 8 pixels source par tour.
+void ScalerLn16_SSE2(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u16	*pDst2 = (u16 *)pDst;
+	__m128i	vClr, vR, vG, vB, vLo, vHi;
+	u16	pTmp[8];
+	u32	i;
+
+	for (; nPix >= 8; nPix -= 8, pSrc += 8, pDst2 += 8 * nFactor)
+	{
+		vClr = _mm_loadu_si128((__m128i *)pSrc);
+		if (nTV)
+		{
+			Scaler_sub_Split_SSE2(vClr, 1, &vR, &vG, &vB);
+			vClr = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(vR, 3), 11),
+				_mm_slli_epi16(_mm_srli_epi16(vG, 2), 5)), _mm_srli_epi16(vB, 3));
+		}
+		switch (nFactor)
+		{
+		case 1:
+			_mm_storeu_si128((__m128i *)pDst2, vClr);
+			break;
+		case 2:
+			_mm_storeu_si128((__m128i *)pDst2, _mm_unpacklo_epi16(vClr, vClr));
+			_mm_storeu_si128((__m128i *)(pDst2 + 8), _mm_unpackhi_epi16(vClr, vClr));
+			break;
+		case 4:
+			vLo = _mm_unpacklo_epi16(vClr, vClr);
+			vHi = _mm_unpackhi_epi16(vClr, vClr);
+			_mm_storeu_si128((__m128i *)pDst2, _mm_unpacklo_epi32(vLo, vLo));
+			_mm_storeu_si128((__m128i *)(pDst2 + 8), _mm_unpackhi_epi32(vLo, vLo));
+			_mm_storeu_si128((__m128i *)(pDst2 + 16), _mm_unpacklo_epi32(vHi, vHi));
+			_mm_storeu_si128((__m128i *)(pDst2 + 24), _mm_unpackhi_epi32(vHi, vHi));
+			break;
+		default:	// x3 : Pas de shuffle 16 bits en SSE2.
+			_mm_storeu_si128((__m128i *)pTmp, vClr);
+			for (i = 0; i < 8; i++)
+				pDst2[i * 3] = pDst2[(i * 3) + 1] = pDst2[(i * 3) + 2] = pTmp[i];
+			break;
+		}
+	}
+	if (nPix) ScalerLn16_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+
+// Ecriture de 4 pixels 32 bits agrandis.
+void Scaler_sub_Store32_SSE2(u32 *pDst, __m128i vClr, u32 nFactor)
+{
+	switch (nFactor)
+	{
+	case 1:
+		_mm_storeu_si128((__m128i *)pDst, vClr);
+		break;
+	case 2:
+		_mm_storeu_si128((__m128i *)pDst, _mm_unpacklo_epi32(vClr, vClr));
+		_mm_storeu_si128((__m128i *)(pDst + 4), _mm_unpackhi_epi32(vClr, vClr));
+		break;
+	case 3:
+		_mm_storeu_si128((__m128i *)pDst, _mm_shuffle_epi32(vClr, _MM_SHUFFLE(1, 0, 0, 0)));
+		_mm_storeu_si128((__m128i *)(pDst + 4), _mm_shuffle_epi32(vClr, _MM_SHUFFLE(2, 2, 1, 1)));
+		_mm_storeu_si128((__m128i *)(pDst + 8), _mm_shuffle_epi32(vClr, _MM_SHUFFLE(3, 3, 3, 2)));
+		break;
+	default:
+		_mm_storeu_si128((__m128i *)pDst, _mm_shuffle_epi32(vClr, 0x00));
+		_mm_storeu_si128((__m128i *)(pDst + 4), _mm_shuffle_epi32(vClr, 0x55));
+		_mm_storeu_si128((__m128i *)(pDst + 8), _mm_shuffle_epi32(vClr, 0xAA));
+		_mm_storeu_si128((__m128i *)(pDst + 12), _mm_shuffle_epi32(vClr, 0xFF));
+		break;
+	}
+}
+
+// SSE2, destination 32 bits, 8 pixels source par tour. La conversion 565 > 8888 est calcule, pas de CLUT.
+void ScalerLn32_SSE2(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	__m128i	vR, vG, vB, vGB;
+
+	for (; nPix >= 8; nPix -= 8, pSrc += 8, pDst2 += 8 * nFactor)
+	{
+		Scaler_sub_Split_SSE2(_mm_loadu_si128((__m128i *)pSrc), nTV, &vR, &vG, &vB);
+		vGB = _mm_or_si128(_mm_slli_epi16(vG, 8), vB);
+		// Entrelacement GB / R (poids forts) => 0x00RRGGBB.
+		Scaler_sub_Store32_SSE2(pDst2, _mm_unpacklo_epi16(vGB, vR), nFactor);
+		Scaler_sub_Store32_SSE2(pDst2 + (4 * nFactor), _mm_unpackhi_epi16(vGB, vR), nFactor);
+	}
+	if (nPix) ScalerLn32_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+#endif
+
+#ifdef SCALERSIMD_WASM
+// 8 pixels 565 > composantes 8 bits (comme SDL_GetRGB), assombries pour les lignes TV.
+void Scaler_sub_Split_Wasm(v128_t vClr, u32 nTV, v128_t *pR, v128_t *pG, v128_t *pB)
+{
+	v128_t	vR, vG, vB;
+
+	vR = wasm_u16x8_shr(vClr, 11);
+	vG = wasm_v128_and(wasm_u16x8_shr(vClr, 5), wasm_i16x8_splat(0x3F));
+	vB = wasm_v128_and(vClr, wasm_i16x8_splat(0x1F));
+	vR = wasm_v128_or(wasm_i16x8_shl(vR, 3), wasm_u16x8_shr(vR, 2));
+	vG = wasm_v128_or(wasm_i16x8_shl(vG, 2), wasm_u16x8_shr(vG, 4));
+	vB = wasm_v128_or(wasm_i16x8_shl(vB, 3), wasm_u16x8_shr(vB, 2));
+	if (nTV)
+	{
+		vR = wasm_u16x8_shr(wasm_i16x8_mul(vR, wasm_i16x8_splat(SCALER_TV_FACTOR)), 8);
+		vG = wasm_u16x8_shr(wasm_i16x8_mul(vG, wasm_i16x8_splat(SCALER_TV_FACTOR)), 8);
+		vB = wasm_u16x8_shr(wasm_i16x8_mul(vB, wasm_i16x8_splat(SCALER_TV_FACTOR)), 8);
+	}
+	*pR = vR;
+	*pG = vG;
+	*pB = vB;
+}
+
+// WebAssembly simd128, destination 16 bits, 8 pixels source par tour.
+void ScalerLn16_Wasm(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u16	*pDst2 = (u16 *)pDst;
+	v128_t	vClr, vR, vG, vB;
+
+	for (; nPix >= 8; nPix -= 8, pSrc += 8, pDst2 += 8 * nFactor)
+	{
+		vClr = wasm_v128_load(pSrc);
+		if (nTV)
+		{
+			Scaler_sub_Split_Wasm(vClr, 1, &vR, &vG, &vB);
+			vClr = wasm_v128_or(wasm_v128_or(wasm_i16x8_shl(wasm_u16x8_shr(vR, 3), 11),
+				wasm_i16x8_shl(wasm_u16x8_shr(vG, 2), 5)), wasm_u16x8_shr(vB, 3));
+		}
+		switch (nFactor)
+		{
+		case 1:
+			wasm_v128_store(pDst2, vClr);
+			break;
+		case 2:
+			wasm_v128_store(pDst2, wasm_i16x8_shuffle(vClr, vClr, 0, 0, 1, 1, 2, 2, 3, 3));
+			wasm_v128_store(pDst2 + 8, wasm_i16x8_shuffle(vClr, vClr, 4, 4, 5, 5, 6, 6, 7, 7));
+			break;
+		case 3:
+			wasm_v128_store(pDst2, wasm_i16x8_shuffle(vClr, vClr, 0, 0, 0, 1, 1, 1, 2, 2));
+			wasm_v128_store(pDst2 + 8, wasm_i16x8_shuffle(vClr, vClr, 2, 3, 3, 3, 4, 4, 4, 5));
+			wasm_v128_store(pDst2 + 16, wasm_i16x8_shuffle(vClr, vClr, 5, 5, 6, 6, 6, 7, 7, 7));
+			break;
+		default:
+			wasm_v128_store(pDst2, wasm_i16x8_shuffle(vClr, vClr, 0, 0, 0, 0, 1, 1, 1, 1));
+			wasm_v128_store(pDst2 + 8, wasm_i16x8_shuffle(vClr, vClr, 2, 2, 2, 2, 3, 3, 3, 3));
+			wasm_v128_store(pDst2 + 16, wasm_i16x8_shuffle(vClr, vClr, 4, 4, 4, 4, 5, 5, 5, 5));
+			wasm_v128_store(pDst2 + 24, wasm_i16x8_shuffle(vClr, vClr, 6, 6, 6, 6, 7, 7, 7, 7));
+			break;
+		}
+	}
+	if (nPix) ScalerLn16_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+
+// Ecriture de 4 pixels 32 bits agrandis.
+void Scaler_sub_Store32_Wasm(u32 *pDst, v128_t vClr, u32 nFactor)
+{
+	switch (nFactor)
+	{
+	case 1:
+		wasm_v128_store(pDst, vClr);
+		break;
+	case 2:
+		wasm_v128_store(pDst, wasm_i32x4_shuffle(vClr, vClr, 0, 0, 1, 1));
+		wasm_v128_store(pDst + 4, wasm_i32x4_shuffle(vClr, vClr, 2, 2, 3, 3));
+		break;
+	case 3:
+		wasm_v128_store(pDst, wasm_i32x4_shuffle(vClr, vClr, 0, 0, 0, 1));
+		wasm_v128_store(pDst + 4, wasm_i32x4_shuffle(vClr, vClr, 1, 1, 2, 2));
+		wasm_v128_store(pDst + 8, wasm_i32x4_shuffle(vClr, vClr, 2, 3, 3, 3));
+		break;
+	default:
+		wasm_v128_store(pDst, wasm_i32x4_shuffle(vClr, vClr, 0, 0, 0, 0));
+		wasm_v128_store(pDst + 4, wasm_i32x4_shuffle(vClr, vClr, 1, 1, 1, 1));
+		wasm_v128_store(pDst + 8, wasm_i32x4_shuffle(vClr, vClr, 2, 2, 2, 2));
+		wasm_v128_store(pDst + 12, wasm_i32x4_shuffle(vClr, vClr, 3, 3, 3, 3));
+		break;
+	}
+}
+
+// WebAssembly simd128, destination 32 bits, 8 pixels source par tour.
+void ScalerLn32_Wasm(u16 *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	v128_t	vR, vG, vB, vGB;
+
+	for (; nPix >= 8; nPix -= 8, pSrc += 8, pDst2 += 8 * nFactor)
+	{
+		Scaler_sub_Split_Wasm(wasm_v128_load(pSrc), nTV, &vR, &vG, &vB);
+		vGB = wasm_v128_or(wasm_i16x8_shl(vG, 8), vB);
+		Scaler_sub_Store32_Wasm(pDst2, wasm_i16x8_shuffle(vGB, vR, 0, 8, 1, 9, 2, 10, 3, 11), nFactor);
+		Scaler_sub_Store32_Wasm(pDst2 + (4 * nFactor), wasm_i16x8_shuffle(vGB, vR, 4, 12, 5, 13, 6, 14, 7, 15), nFactor);
+	}
+	if (nPix) ScalerLn32_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+#endif
+
+#if FB32_ON == 1
+// Source XRGB8888 : Plus de conversion vers une sortie 32 bits, il ne reste que l'agrandissement et l'assombrissement TV.
+#define	SCALER_TV32(c)	((SCALER_TV(((c) >> 16) & 0xFF) << 16) | (SCALER_TV(((c) >> 8) & 0xFF) << 8) | SCALER_TV((c) & 0xFF))
+
+// Version C, source 32 bits, destination 16 bits (arrondi comme SDL_MapRGB).
+void ScalerLn16_Src32_C(upix *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u16	*pDst2 = (u16 *)pDst;
+	u32	nClr, k;
+
+	for (; nPix; nPix--)
+	{
+		nClr = *pSrc++;
+		if (nTV) nClr = SCALER_TV32(nClr);
+		nClr = ((nClr >> 8) & 0xF800) | ((nClr >> 5) & 0x07E0) | ((nClr >> 3) & 0x001F);
+		for (k = nFactor; k; k--) *pDst2++ = nClr;
+	}
+}
+
+// Version C, source 32 bits, destination 32 bits.
+void ScalerLn32_Src32_C(upix *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	u32	nClr, k;
+
+	for (; nPix; nPix--)
+	{
+		nClr = *pSrc++;
+		if (nTV) nClr = SCALER_TV32(nClr);
+		for (k = nFactor; k; k--) *pDst2++ = nClr;
+	}
+}
+
+#ifdef SCALERSIMD_SSE2
+// SSE2, source et destination 32 bits, 4 pixels par tour.
+void ScalerLn32_Src32_SSE2(upix *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	__m128i	vClr, vZero, vTV;
+
+	vZero = _mm_setzero_si128();
+	vTV = _mm_set1_epi16(SCALER_TV_FACTOR);
+	for (; nPix >= 4; nPix -= 4, pSrc += 4, pDst2 += 4 * nFactor)
+	{
+		vClr = _mm_loadu_si128((__m128i *)pSrc);
+		if (nTV)
+			vClr = _mm_packus_epi16(
+				_mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(vClr, vZero), vTV), 8),
+				_mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(vClr, vZero), vTV), 8));
+		Scaler_sub_Store32_SSE2(pDst2, vClr, nFactor);
+	}
+	if (nPix) ScalerLn32_Src32_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+#endif
+
+#ifdef SCALERSIMD_WASM
+// WebAssembly simd128, source et destination 32 bits, 4 pixels par tour.
+void ScalerLn32_Src32_Wasm(upix *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV)
+{
+	u32	*pDst2 = (u32 *)pDst;
+	v128_t	vClr, vTV;
+
+	vTV = wasm_i16x8_splat(SCALER_TV_FACTOR);
+	for (; nPix >= 4; nPix -= 4, pSrc += 4, pDst2 += 4 * nFactor)
+	{
+		vClr = wasm_v128_load(pSrc);
+		if (nTV)
+			vClr = wasm_u8x16_narrow_i16x8(
+				wasm_u16x8_shr(wasm_i16x8_mul(wasm_u16x8_extend_low_u8x16(vClr), vTV), 8),
+				wasm_u16x8_shr(wasm_i16x8_mul(wasm_u16x8_extend_high_u8x16(vClr), vTV), 8));
+		Scaler_sub_Store32_Wasm(pDst2, vClr, nFactor);
+	}
+	if (nPix) ScalerLn32_Src32_C(pSrc, pDst2, nPix, nFactor, nTV);	// Reste.
+}
+#endif
+#endif
+
+//=============================================================================
+
+// Le travail de la frame en cours.
+struct SScalerJob
+{
+	u8	*pSrc, *pDst;
+	s32	nSrcPitch, nDstPitch;	// En octets.
+	u32	nWidth, nHeight;		// Taille de la source.
+	u32	nFactor, nTV;
+	u32	nLnSz;					// Taille d'une ligne destination, en octets.
+	pScalerLn	pLn;
+};
+struct SScalerJob	gScalerJob;
+
+#define	SCALERMT_BANDS_MAX	8
+u32	gnScalerMTBandsNb = 1;		// Nb de bandes (thread principal compris). 1 = pas de multithread.
+
+// Scaling d'une bande de lignes source.
+void Scaler_sub_Band(u32 nBand)
+{
+	u32	y, k, nYMin, nYMax, nNormal;
+	u8	*pSrc, *pDst, *pDstLn;
+
+	nYMin = (nBand * gScalerJob.nHeight) / gnScalerMTBandsNb;
+	nYMax = ((nBand + 1) * gScalerJob.nHeight) / gnScalerMTBandsNb;
+	nNormal = (gScalerJob.nTV ? (gScalerJob.nFactor + 1) / 2 : gScalerJob.nFactor);	// Nb de lignes normales.
+
+	pSrc = gScalerJob.pSrc + (nYMin * gScalerJob.nSrcPitch);
+	pDst = gScalerJob.pDst + (nYMin * gScalerJob.nFactor * gScalerJob.nDstPitch);
+	for (y = nYMin; y < nYMax; y++)
+	{
+		// Lignes normales : 1 conversion, puis des copies.
+		gScalerJob.pLn((upix *)pSrc, pDst, gScalerJob.nWidth, gScalerJob.nFactor, 0);
+		for (k = 1, pDstLn = pDst + gScalerJob.nDstPitch; k < nNormal; k++, pDstLn += gScalerJob.nDstPitch)
+			memcpy(pDstLn, pDst, gScalerJob.nLnSz);
+		// Lignes TV.
+		if (k < gScalerJob.nFactor)
+		{
+			gScalerJob.pLn((upix *)pSrc, pDstLn, gScalerJob.nWidth, gScalerJob.nFactor, 1);
+			for (k++; k < gScalerJob.nFactor; k++)
+				memcpy(pDstLn + ((k - nNormal) * gScalerJob.nDstPitch), pDstLn, gScalerJob.nLnSz);
+		}
+		pSrc += gScalerJob.nSrcPitch;
+		pDst += gScalerJob.nFactor * gScalerJob.nDstPitch;
+	}
+}
+
+#if SCALERMT_ON == 1
+struct SScalerMTBand
+{
+	SDL_Thread	*pThread;
+	SDL_sem	*pSemStart;
+};
+struct SScalerMTBand	gpScalerMTBands[SCALERMT_BANDS_MAX];
+SDL_sem	*gpScalerMTSemDone;		// Fin de scaling des threads.
+volatile u8	gnScalerMTQuit;
+
+// Boucle des threads de scaling.
+int ScalerMT_sub_Worker(void *pData)
+{
+	u32	nBand = (u32)(intptr_t)pData;
+
+	while (1)
+	{
+		SDL_SemWait(gpScalerMTBands[nBand].pSemStart);
+		if (gnScalerMTQuit) break;
+		Scaler_sub_Band(nBand);
+		SDL_SemPost(gpScalerMTSemDone);
+	}
+	return (0);
+}
+#endif
+
+#ifdef DEBUG_INFO
+#if FB32_ON == 1
+#define	SCALER_LN32_C	ScalerLn32_Src32_C
+#else
+#define	SCALER_LN32_C	ScalerLn32_C
+#endif
+#endif
+
+// Init (1 fois !).
+void ScalerInit(void)
+{
+	u32	nSame;
+
+	nSame = Scaler_sub_CalculateTables();
+
+#if FB32_ON == 1
+	// Source 32 bits : Pas de conversion vers le 32 bits, le SIMD est toujours utilisable.
+	(void)nSame;
+	gpScalerLn16 = ScalerLn16_Src32_C;
+	gpScalerLn32 = ScalerLn32_Src32_C;
+	#if defined(SCALERSIMD_WASM)
+	gpScalerLn32 = ScalerLn32_Src32_Wasm;
+	#elif defined(SCALERSIMD_SSE2)
+	gpScalerLn32 = ScalerLn32_Src32_SSE2;
+	#endif
+#else
+	// Choix des routines. (Les routines SIMD calculent les conversions, on ne les prend que si la SDL donne les mmes couleurs).
+	gpScalerLn16 = ScalerLn16_C;
+	gpScalerLn32 = ScalerLn32_C;
+	if (nSame)
+	{
+#if defined(SCALERSIMD_WASM)
+		gpScalerLn16 = ScalerLn16_Wasm;
+		gpScalerLn32 = ScalerLn32_Wasm;
+#elif defined(SCALERSIMD_SSE2)
+		gpScalerLn16 = ScalerLn16_SSE2;
+		gpScalerLn32 = ScalerLn32_SSE2;
+#endif
+	}
+#endif
+
+	// Threads.
+	gnScalerMTBandsNb = 1;
+#if SCALERMT_ON == 1
+	u32	i;
+
+	gnScalerMTQuit = 0;
+	i = SDL_GetCPUCount();
+	if (i > SCALERMT_BANDS_MAX) i = SCALERMT_BANDS_MAX;
+	if (i < 2 || (gpScalerMTSemDone = SDL_CreateSemaphore(0)) == NULL) goto _MTEnd;
+	for (gnScalerMTBandsNb = i, i = 1; i < gnScalerMTBandsNb; i++)
+	{
+		gpScalerMTBands[i].pThread = NULL;
+		gpScalerMTBands[i].pSemStart = NULL;
+	}
+	for (i = 1; i < gnScalerMTBandsNb; i++)		// Bande 0 : Thread principal.
+	{
+		if ((gpScalerMTBands[i].pSemStart = SDL_CreateSemaphore(0)) == NULL ||
+			(gpScalerMTBands[i].pThread = SDL_CreateThread(ScalerMT_sub_Worker, "ScalerBand", (void *)(intptr_t)i)) == NULL)
+		{
+			fprintf(stderr, "ScalerInit(): Thread creation failed, single thread scaling.\n");
+			ScalerRelease();
+			break;
+		}
+	}
+_MTEnd:
+	;
+#endif
+
+#ifdef DEBUG_INFO
+printf("ScalerInit: %s, %d bands.\n", (gpScalerLn32 == SCALER_LN32_C ? "C" : "SIMD"), (int)gnScalerMTBandsNb);
+#endif
+}
+
+// Arrt des threads (1 fois !).
+void ScalerRelease(void)
+{
+#if SCALERMT_ON == 1
+	u32	i;
+
+	gnScalerMTQuit = 1;
+	for (i = 1; i < gnScalerMTBandsNb; i++)
+	{
+		if (gpScalerMTBands[i].pThread != NULL)
+		{
+			SDL_SemPost(gpScalerMTBands[i].pSemStart);
+			SDL_WaitThread(gpScalerMTBands[i].pThread, NULL);
+		}
+		if (gpScalerMTBands[i].pSemStart != NULL) SDL_DestroySemaphore(gpScalerMTBands[i].pSemStart);
+	}
+	if (gnScalerMTBandsNb > 1) SDL_DestroySemaphore(gpScalerMTSemDone);
+#endif
+	gnScalerMTBandsNb = 1;
+}
+
+// Le format destination est-il gr par les scalers ? (565 ou XRGB8888, sans alpha).
+u32 ScalerDstFormatOk(SDL_PixelFormat *pFmt)
+{
+	if (pFmt->Amask) return (0);
+	if (pFmt->BytesPerPixel == 2)
+		return (pFmt->Rmask == 0xF800 && pFmt->Gmask == 0x07E0 && pFmt->Bmask == 0x001F);
+	if (pFmt->BytesPerPixel == 4)
+		return (pFmt->Rmask == SCALER_DST32_RMASK && pFmt->Gmask == SCALER_DST32_GMASK && pFmt->Bmask == SCALER_DST32_BMASK);
+	return (0);
+}
+
+// Scaling d'un buffer source (format de l'cran du jeu, nWidth x nHeight) vers un buffer destination (565 ou XRGB8888 suivant nDstBpp, 2 ou 4), x nFactor.
+// La destination doit faire au moins (nWidth * nFactor) x (nHeight * nFactor) pixels. Buffers dj locks.
+void ScalerRenderBuf(upix *pSrc, s32 nSrcPitch, u32 nWidth, u32 nHeight, void *pDst, s32 nDstPitch, u32 nDstBpp, u32 nFactor, u32 nTV)
+{
+	if (nFactor < 1 || nFactor > SCALER_FACTOR_MAX) return;
+
+	gScalerJob.pSrc = (u8 *)pSrc;
+	gScalerJob.pDst = (u8 *)pDst;
+	gScalerJob.nSrcPitch = nSrcPitch;
+	gScalerJob.nDstPitch = nDstPitch;
+	gScalerJob.nWidth = nWidth;
+	gScalerJob.nHeight = nHeight;
+	gScalerJob.nFactor = nFactor;
+	gScalerJob.nTV = nTV;
+	gScalerJob.nLnSz = nWidth * nFactor * nDstBpp;
+	gScalerJob.pLn = (nDstBpp == 4 ? gpScalerLn32 : gpScalerLn16);
+
+#if SCALERMT_ON == 1
+	u32	i;
+
+	for (i = 1; i < gnScalerMTBandsNb; i++) SDL_SemPost(gpScalerMTBands[i].pSemStart);
+	Scaler_sub_Band(0);
+	for (i = 1; i < gnScalerMTBandsNb; i++) SDL_SemWait(gpScalerMTSemDone);
+#else
+	Scaler_sub_Band(0);
+#endif
+}
+
+// Scaling de la surface source (format de l'cran du jeu) vers la surface destination (565 ou XRGB8888), x nFactor, en haut  gauche.
+void ScalerRender(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst, u32 nFactor, u32 nTV)
+{
+	if (pSDL_Dst->w < pSDL_Src->w * (s32)nFactor || pSDL_Dst->h < pSDL_Src->h * (s32)nFactor) return;	// Destination trop petite.
+
+	SDL_LockSurface(pSDL_Src);
+	SDL_LockSurface(pSDL_Dst);
+	ScalerRenderBuf((upix *)pSDL_Src->pixels, pSDL_Src->pitch, pSDL_Src->w, pSDL_Src->h,
+		pSDL_Dst->pixels, pSDL_Dst->pitch, pSDL_Dst->format->BytesPerPixel, nFactor, nTV);
+	SDL_UnlockSurface(pSDL_Src);
+	SDL_UnlockSurface(pSDL_Dst);
+}
+
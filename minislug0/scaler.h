@@ -0,0 +1,31 @@
+
+#define	SCALERSIMD_ON	1	// 1 = scalers SIMD si dispo (SSE2/simd128) / 0 = code C seul.
+
+#ifdef __EMSCRIPTEN__
+#define	SCALERMT_ON	0	// Pas de threads en WASM.
+#else
+#define	SCALERMT_ON	1	// 1 = scaling multithread (bandes de lignes) / 0 = un seul thread.
+#endif
+
+#define	SCALER_FACTOR_MAX	4
+#define	SCALER_TV_FACTOR	200		// Lignes TV : * factor, / 256.
+
+// Source au format de l'cran du jeu (565, ou XRGB8888 avec FB32_ON). Destination 16 bits (565) ou 32 bits (XRGB8888).
+#define	SCALER_DST32_RMASK	0x00FF0000
+#define	SCALER_DST32_GMASK	0x0000FF00
+#define	SCALER_DST32_BMASK	0x000000FF
+
+// Conversion + agrandissement x nFactor d'une ligne. nTV = 1 : Couleurs assombries (lignes "TV").
+typedef void (*pScalerLn)(upix *pSrc, void *pDst, u32 nPix, u32 nFactor, u32 nTV);
+
+// Assombrissement TV d'un pixel 565.
+extern u16	gppScalerTV16R[32], gppScalerTV16G[64], gppScalerTV16B[32];
+#define	SCALER_TV16(c)	(gppScalerTV16R[(c) >> 11] | gppScalerTV16G[((c) >> 5) & 0x3F] | gppScalerTV16B[(c) & 0x1F])
+
+// Prototypes.
+void ScalerInit(void);
+void ScalerRelease(void);
+u32 ScalerDstFormatOk(SDL_PixelFormat *pFmt);
+void ScalerRenderBuf(upix *pSrc, s32 nSrcPitch, u32 nWidth, u32 nHeight, void *pDst, s32 nDstPitch, u32 nDstBpp, u32 nFactor, u32 nTV);
+void ScalerRender(SDL_Surface *pSDL_Src, SDL_Surface *pSDL_Dst, u32 nFactor, u32 nTV);
+
@@ -8,9 +8,15 @@
 
 struct SScrollPos	gScrollPos;
 
+#define	SCROLLBUF_LG	512		// Taille du buffer � rouleaux (en pixels).
+#define	SCROLLBUF_HT	256
+
 struct SScrollMulti
 {
 	struct SDL_Surface	*ppPlanesScrollBuf[MAP_PLANES_MAX];	// Buffers de scroll des plans.
+	// Cases de 16x16 du buffer, 1 bit par colonne (SCROLLBUF_LG / 16 = 32) et un mot par ligne de blocs.
+	u32	ppnCellDraw[MAP_PLANES_MAX][SCROLLBUF_HT / 16];		// 0 = Bloc vide, rien à tracer.
+	u32	ppnCellOpaque[MAP_PLANES_MAX][SCROLLBUF_HT / 16];	// 1 = Bloc opaque, copie sans couleur transparente.
 	s32	pPlanePosX[MAP_PLANES_MAX];	// Positions de chaque plan.
 	s32	pPlanePosY[MAP_PLANES_MAX];
 	s32	pPlaneNewPosX[MAP_PLANES_MAX];	// Nouvelles positions de chaque plan, utilis�es lors du calcul du diff�rentiel.
@@ -19,10 +25,6 @@ struct SScrollMulti
 };
 struct SScrollMulti	gScrollM;
 
-
-#define	SCROLLBUF_LG	512		// Taille du buffer � rouleaux (en pixels).
-#define	SCROLLBUF_HT	256
-
 // Alloue les buffers de scroll. 1 seule fois !
 void ScrollAllocate(void)
 {
@@ -32,12 +34,13 @@ void ScrollAllocate(void)
 	{
 		//gScrollM.ppPlanesScrollBuf[i] = SDL_CreateRGBSurface(SDL_HWSURFACE, SCROLLBUF_LG, SCROLLBUF_HT, 16, 0, 0, 0, 0);
 //		gScrollM.ppPlanesScrollBuf[i] = SDL_CreateRGBSurface(SDL_SWSURFACE, SCROLLBUF_LG, SCROLLBUF_HT, 16, 0, 0, 0, 0);
-		gScrollM.ppPlanesScrollBuf[i] = SDL_CreateRGBSurface(0, SCROLLBUF_LG, SCROLLBUF_HT, 16, 0xF800, 0x07E0, 0x001F, 0);
+		gScrollM.ppPlanesScrollBuf[i] = SDL_CreateRGBSurface(0, SCROLLBUF_LG, SCROLLBUF_HT, FB_BPP, FB_RMASK, FB_GMASK, FB_BMASK, 0);
 		if (gScrollM.ppPlanesScrollBuf[i] == NULL)
 		{
 			fprintf(stderr, "ScrollAllocate: Unable to allocate scroll buffers: %s\n", SDL_GetError());
 			exit(1);
 		}
+		RCtx_ScrollBufSet(i, gScrollM.ppPlanesScrollBuf[i]);
 	}
 
 }
@@ -49,54 +52,64 @@ void ScrollRelease(void)
 
 	for (i = 0; i < MAP_PLANES_MAX; i++)
 	{
+		RCtx_ScrollBufSet(i, NULL);
 		SDL_FreeSurface(gScrollM.ppPlanesScrollBuf[i]);
 	}
 }
 
+// Masques de la case (x,y) du buffer, d'après l'opacité du bloc qui y entre.
+// Out : 1 = Bloc à recopier / 0 = Bloc vide, ScrollDisplayPlane ne lira pas la case.
+u32 Scr_sub_CellSet(u32 nPlane, s32 nBlockNo, u32 nCellX, u32 nCellY)
+{
+	u32	nBit = 1 << nCellX;
+	u32	nOpa = gMap.ppBlkOpacity[nPlane][nBlockNo];
+
+	gScrollM.ppnCellDraw[nPlane][nCellY] &= ~nBit;
+	gScrollM.ppnCellOpaque[nPlane][nCellY] &= ~nBit;
+	if (nOpa != e_BlkOpa_Empty) gScrollM.ppnCellDraw[nPlane][nCellY] |= nBit;
+	if (nOpa == e_BlkOpa_Opaque) gScrollM.ppnCellOpaque[nPlane][nCellY] |= nBit;
+#if SCROLL_SPANS_ON == 1
+	return (nOpa != e_BlkOpa_Empty);
+#else
+	return (1);		// SDL_BlitSurface lit tout le buffer.
+#endif
+}
+
 // Copie d'une colonne.
 void Scr_sub_NewCol(u32 nPlane, s32 sBlMapX, s32 sBlMapY)
 {
 	u32	j, k;
 	s32	nBlockNo;
-	u32	nBlX, nBlY;
-	u16	*pSrc, *pDst;
+	upix	*pSrc, *pDst, *pBuf;
+	s32	nPitch;
 
 	// Cas extr�me, compl�tement � droite. Il y a un appel sur la 1ere colonne derri�re la map lors du scroll vers la droite.
 //b	if ((u32)sBlMapX >= gMap.nMapLg) return;
 	if ((u32)sBlMapX >= gMap.pPlanesLg[nPlane]) return;
 
 	// Trace la colonne.
-	SDL_LockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
+	pBuf = RCTX()->ppScroll[nPlane];
+	nPitch = gRCtx.pnScrollPitch[nPlane];
 	//for (j = 0; j < (SCR_Height / 16) + 1; j++)
 //b	for (j = 0; j < (SCR_Height / 16) + 1 && sBlMapY + j < gMap.nMapHt; j++)
 	for (j = 0; j < (SCR_Height / 16) + 1 && sBlMapY + j < gMap.pPlanesHt[nPlane]; j++)
 	{
 		nBlockNo = *(*(gMap.ppPlanesBlocks + nPlane) + ((sBlMapY + j) * gMap.nMapLg) + sBlMapX);
-		// Coordon�es x,y du bloc dans son plan.
-		nBlY = nBlockNo / (gMap.ppPlanesGfx[nPlane]->w / 16);
-		nBlX = nBlockNo - (nBlY * (gMap.ppPlanesGfx[nPlane]->w / 16));
-		// Src et Dst.
-		pSrc = (u16 *)gMap.ppPlanesGfx[nPlane]->pixels + (nBlY * 16 * gMap.ppPlanesGfx[nPlane]->w) + (nBlX * 16);
-		pDst = (u16 *)gScrollM.ppPlanesScrollBuf[nPlane]->pixels +
-			((((sBlMapY + j) % (SCROLLBUF_HT / 16)) * 16) * SCROLLBUF_LG) +
+		if (Scr_sub_CellSet(nPlane, nBlockNo, sBlMapX % (SCROLLBUF_LG / 16), (sBlMapY + j) % (SCROLLBUF_HT / 16)) == 0) continue;
+		// Src (bloc dans la planche recopiée à la suite) et Dst.
+		pSrc = gMap.ppBlkTiles[nPlane] + (nBlockNo * BLK_TILE_PIX);
+		pDst = pBuf +
+			((((sBlMapY + j) % (SCROLLBUF_HT / 16)) * 16) * nPitch) +
 			((sBlMapX % (SCROLLBUF_LG / 16)) * 16);
 		// Bloc.
 		for (k = 0; k < 16; k++)
 		{
-			*(u32 *)pDst = *(u32 *)pSrc;
-			*(u32 *)(pDst + 2) = *(u32 *)(pSrc + 2);
-			*(u32 *)(pDst + 4) = *(u32 *)(pSrc + 4);
-			*(u32 *)(pDst + 6) = *(u32 *)(pSrc + 6);
-			*(u32 *)(pDst + 8) = *(u32 *)(pSrc + 8);
-			*(u32 *)(pDst + 10) = *(u32 *)(pSrc + 10);
-			*(u32 *)(pDst + 12) = *(u32 *)(pSrc + 12);
-			*(u32 *)(pDst + 14) = *(u32 *)(pSrc + 14);
-			pSrc += gMap.ppPlanesGfx[nPlane]->w;
-			pDst += SCROLLBUF_LG;
+			memcpy(pDst, pSrc, 16 * sizeof(upix));	// 16 pixels, taille fixe => copie inline (16 ou 32 bits).
+			pSrc += 16;
+			pDst += nPitch;
 		}
 
 	}
-	SDL_UnlockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
 
 	AnmBlkScrollNewCol(nPlane, sBlMapX, sBlMapY);	// Update des blocs anim�s entrant sur la colonne.
 
@@ -107,45 +120,36 @@ void Scr_sub_NewLn(u32 nPlane, s32 sBlMapX, s32 sBlMapY)
 {
 	u32	i, k;
 	s32	nBlockNo;
-	u32	nBlX, nBlY;
-	u16	*pSrc, *pDst;
+	upix	*pSrc, *pDst, *pBuf;
+	s32	nPitch;
 
 	// Cas extr�me, compl�tement en bas. Il y a un appel sur la 1ere ligne sous la map lors du scroll vers le bas.
 //b	if ((u32)sBlMapY >= gMap.nMapHt) return;
 	if ((u32)sBlMapY >= gMap.pPlanesHt[nPlane]) return;
 
 	// Trace la ligne.
-	SDL_LockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
+	pBuf = RCTX()->ppScroll[nPlane];
+	nPitch = gRCtx.pnScrollPitch[nPlane];
 	//for (i = 0; i < (SCR_Width / 16) + 1; i++)
 //b	for (i = 0; i < (SCR_Width / 16) + 1 && sBlMapX + i < gMap.nMapLg; i++)
 	for (i = 0; i < (SCR_Width / 16) + 1 && sBlMapX + i < gMap.pPlanesLg[nPlane]; i++)
 	{
 		nBlockNo = *(*(gMap.ppPlanesBlocks + nPlane) + (sBlMapY * gMap.nMapLg) + sBlMapX + i);
-		// Coordon�es x,y du bloc dans son plan.
-		nBlY = nBlockNo / (gMap.ppPlanesGfx[nPlane]->w / 16);
-		nBlX = nBlockNo - (nBlY * (gMap.ppPlanesGfx[nPlane]->w / 16));
-		// Src et Dst.
-		pSrc = (u16 *)gMap.ppPlanesGfx[nPlane]->pixels + (nBlY * 16 * gMap.ppPlanesGfx[nPlane]->w) + (nBlX * 16);
-		pDst = (u16 *)gScrollM.ppPlanesScrollBuf[nPlane]->pixels +
-			(((sBlMapY % (SCROLLBUF_HT / 16)) * 16) * SCROLLBUF_LG) +
+		if (Scr_sub_CellSet(nPlane, nBlockNo, (sBlMapX + i) % (SCROLLBUF_LG / 16), sBlMapY % (SCROLLBUF_HT / 16)) == 0) continue;
+		// Src (bloc dans la planche recopiée à la suite) et Dst.
+		pSrc = gMap.ppBlkTiles[nPlane] + (nBlockNo * BLK_TILE_PIX);
+		pDst = pBuf +
+			(((sBlMapY % (SCROLLBUF_HT / 16)) * 16) * nPitch) +
 			(((sBlMapX + i) % (SCROLLBUF_LG / 16)) * 16);
 		// Bloc.
 		for (k = 0; k < 16; k++)
 		{
-			*(u32 *)pDst = *(u32 *)pSrc;
-			*(u32 *)(pDst + 2) = *(u32 *)(pSrc + 2);
-			*(u32 *)(pDst + 4) = *(u32 *)(pSrc + 4);
-			*(u32 *)(pDst + 6) = *(u32 *)(pSrc + 6);
-			*(u32 *)(pDst + 8) = *(u32 *)(pSrc + 8);
-			*(u32 *)(pDst + 10) = *(u32 *)(pSrc + 10);
-			*(u32 *)(pDst + 12) = *(u32 *)(pSrc + 12);
-			*(u32 *)(pDst + 14) = *(u32 *)(pSrc + 14);
-			pSrc += gMap.ppPlanesGfx[nPlane]->w;
-			pDst += SCROLLBUF_LG;
+			memcpy(pDst, pSrc, 16 * sizeof(upix));	// Idem.
+			pSrc += 16;
+			pDst += nPitch;
 		}
 
 	}
-	SDL_UnlockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
 
 	AnmBlkScrollNewLn(nPlane, sBlMapX, sBlMapY);	// Update des blocs anim�s entrant sur la ligne.
 
@@ -333,6 +337,11 @@ gnScrollLimitYMin = gnScrollLimitYMax = -1;
 		gScrollM.pPlanePosX[nPlane] = gScrollM.pPlaneNewPosX[nPlane];	// A l'init, pour initialiser pPlanePosX et pPlanePosY.
 		gScrollM.pPlanePosY[nPlane] = gScrollM.pPlaneNewPosY[nPlane];
 
+#if SCROLL_SPANS_ON == 1
+		// RAZ des masques : Les cellules pas redessinées ne doivent pas garder l'état du niveau précédent.
+		memset(gScrollM.ppnCellDraw[nPlane], 0, sizeof(gScrollM.ppnCellDraw[nPlane]));
+		memset(gScrollM.ppnCellOpaque[nPlane], 0, sizeof(gScrollM.ppnCellOpaque[nPlane]));
+#endif
 		for (i = 0; i < (SCR_Width / 16) + 1; i++)
 		{
 			Scr_sub_NewCol(nPlane, (gScrollM.pPlanePosX[nPlane] >> 12) + i, gScrollM.pPlanePosY[nPlane] >> 12);
@@ -487,6 +496,28 @@ gScrollPos.nPosY = nSPosY_sav;	//*** Avec scroll modifi�
 
 }
 
+// Retrace les blocs visibles de tous les plans, après restauration d'un snapshot.
+void ScrollRedraw(void)
+{
+	u32	nPlane;
+	u32	i;
+
+	for (nPlane = 0; nPlane < gMap.nPlanesNb; nPlane++)
+	for (i = 0; i < (SCR_Width / 16) + 1; i++)
+		Scr_sub_NewCol(nPlane, (gScrollM.pPlanePosX[nPlane] >> 12) + i, gScrollM.pPlanePosY[nPlane] >> 12);
+}
+
+// Snapshots : Positions et limites du scroll.
+void ScrollSnapZones(void)
+{
+	SnapZoneAdd(&gScrollPos, sizeof(gScrollPos), NULL, NULL);
+	SnapZoneAdd(&gScrollM, sizeof(gScrollM), NULL, NULL);
+	SnapZoneAdd(&gnScrollLimitXMin, sizeof(gnScrollLimitXMin), NULL, NULL);
+	SnapZoneAdd(&gnScrollLimitXMax, sizeof(gnScrollLimitXMax), NULL, NULL);
+	SnapZoneAdd(&gnScrollLimitYMin, sizeof(gnScrollLimitYMin), NULL, NULL);
+	SnapZoneAdd(&gnScrollLimitYMax, sizeof(gnScrollLimitYMax), NULL, NULL);
+}
+
 typedef void (*pFctScrollPatch) (void);
 
 // Gestion du scroll.
@@ -596,8 +627,83 @@ void ScrollManage(void)
 
 }
 
-extern	u8	gnFrameMissed;
+#if SCROLL_SPANS_ON == 1
+// Affichage d'un morceau de ligne d'un plan transparent, par suites de blocs du même type.
+// In : nX = Début dans la ligne du buffer, nLg = Nb de pixels (pas de rebouclage dans le morceau).
+void Scr_sub_DisplaySpan(upix *pDst, upix *pSrc, u32 nX, u32 nLg, u32 nDraw, u32 nOpaque)
+{
+	u32	nEnd, nNext;
+	u32	nType;
+
+	// Type d'une case : 0 = Vide / 1 = Mixte / 3 = Opaque.
+	#define	CELL_TYPE(nPix)	(((nDraw >> ((nPix) / 16)) & 1) | (((nOpaque >> ((nPix) / 16)) & 1) << 1))
 
+	nEnd = nX + nLg;
+	while (nX < nEnd)
+	{
+		// Jusqu'à la fin de la suite de cases du même type.
+		nType = CELL_TYPE(nX);
+		for (nNext = (nX & ~15) + 16; nNext < nEnd && CELL_TYPE(nNext) == nType; nNext += 16);
+		nNext = MIN(nNext, nEnd);
+
+		if (nType == 3)
+			memcpy(pDst, pSrc + nX, (nNext - nX) * sizeof(upix));
+		else if (nType)
+			gpKeyBlitLn(pDst, pSrc + nX, nNext - nX, gMap.nTranspColorKey);
+		pDst += nNext - nX;
+		nX = nNext;
+	}
+
+	#undef	CELL_TYPE
+}
+
+// Affichage du plan x à l'écran, ligne à ligne depuis le buffer à rouleaux.
+// Rebouclage en x : 2 morceaux par ligne. Rebouclage en y : sur le n° de ligne source.
+// Le plan 0 est opaque (memcpy), les suivants ont la couleur transparente (cf. ScrollInitScreen) : lignes de blocs
+// vides sautées, et dans une ligne, suites de blocs opaques recopiées et suites de blocs mixtes avec couleur transparente.
+void ScrollDisplayPlane(u32 nPlaneNo)
+{
+	struct SRenderCtx	*pCtx;
+	upix	*pSrc, *pDst;
+	u32	nX1, nY1;
+	u32	nLg1, nLg2;
+	u32	nLn, nDraw, nOpaque;
+	u32	j;
+
+	if (nPlaneNo >= gMap.nPlanesNb || gnFrameMissed) return;
+	pCtx = RCTX();
+
+	// Coordonées de la fenêtre dans le buffer.
+	nX1 = (gScrollM.pPlanePosX[nPlaneNo] >> 8) % SCROLLBUF_LG;
+	nY1 = (gScrollM.pPlanePosY[nPlaneNo] >> 8) % SCROLLBUF_HT;
+	nLg1 = MIN(SCR_Width, SCROLLBUF_LG - nX1);	// De nX1 jusqu'au bord droit du buffer.
+	nLg2 = SCR_Width - nLg1;					// La suite, au début de la ligne.
+
+	pDst = pCtx->pScr;
+	if (nPlaneNo == 0)
+	{
+		for (j = 0; j < SCR_Height; j++, pDst += pCtx->nScrPitch)
+		{
+			pSrc = pCtx->ppScroll[nPlaneNo] + (((nY1 + j) % SCROLLBUF_HT) * pCtx->pnScrollPitch[nPlaneNo]);
+			memcpy(pDst, pSrc + nX1, nLg1 * sizeof(upix));
+			if (nLg2) memcpy(pDst + nLg1, pSrc, nLg2 * sizeof(upix));
+		}
+	}
+	else
+	{
+		for (j = 0; j < SCR_Height; j++, pDst += pCtx->nScrPitch)
+		{
+			nLn = (nY1 + j) % SCROLLBUF_HT;
+			if ((nDraw = gScrollM.ppnCellDraw[nPlaneNo][nLn / 16]) == 0) continue;	// Rien sur la ligne.
+			nOpaque = gScrollM.ppnCellOpaque[nPlaneNo][nLn / 16];
+			pSrc = pCtx->ppScroll[nPlaneNo] + (nLn * pCtx->pnScrollPitch[nPlaneNo]);
+			Scr_sub_DisplaySpan(pDst, pSrc, nX1, nLg1, nDraw, nOpaque);
+			if (nLg2) Scr_sub_DisplaySpan(pDst + nLg1, pSrc, 0, nLg2, nDraw, nOpaque);
+		}
+	}
+
+}
+#else
 // Blitte le plan x � l'�cran.
 void ScrollDisplayPlane(u32 nPlaneNo)
 {
@@ -607,6 +713,7 @@ void ScrollDisplayPlane(u32 nPlaneNo)
 
 //	if (nPlaneNo >= gMap.nPlanesNb) return;
 	if (nPlaneNo >= gMap.nPlanesNb || gnFrameMissed) return;
+	RCtx_BlitPrepare();		// Pas de blit avec des surfaces lock�es.
 
 	// Coordon�es de la fen�tre de base.
 	nX1 = (gScrollM.pPlanePosX[nPlaneNo] >> 8) % SCROLLBUF_LG;
@@ -716,6 +823,7 @@ void ScrollDisplayPlane(u32 nPlaneNo)
 	}
 
 }
+#endif
 
 //=============================================================================
 
@@ -731,37 +839,27 @@ void Scroll_BlkAnm_BlockUpdate(u32 nPlane, s32 sBlMapX, s32 sBlMapY, s32 nOffset
 {
 	u32	k;
 	s32	nBlockNo;
-	u32	nBlX, nBlY;
-	u16	*pSrc, *pDst;
+	upix	*pSrc, *pDst, *pBuf;
+	s32	nPitch;
 
 	// Trace la colonne.
-	SDL_LockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
+	pBuf = RCTX()->ppScroll[nPlane];
+	nPitch = gRCtx.pnScrollPitch[nPlane];
 
 	nBlockNo = *(*(gMap.ppPlanesBlocks + nPlane) + (sBlMapY * gMap.nMapLg) + sBlMapX) + nOffset;
-	// Coordon�es x,y du bloc dans son plan.
-	nBlY = nBlockNo / (gMap.ppPlanesGfx[nPlane]->w / 16);
-	nBlX = nBlockNo - (nBlY * (gMap.ppPlanesGfx[nPlane]->w / 16));
-	// Src et Dst.
-	pSrc = (u16 *)gMap.ppPlanesGfx[nPlane]->pixels + (nBlY * 16 * gMap.ppPlanesGfx[nPlane]->w) + (nBlX * 16);
-	pDst = (u16 *)gScrollM.ppPlanesScrollBuf[nPlane]->pixels +
-		(((sBlMapY % (SCROLLBUF_HT / 16)) * 16) * SCROLLBUF_LG) +
+	if (Scr_sub_CellSet(nPlane, nBlockNo, sBlMapX % (SCROLLBUF_LG / 16), sBlMapY % (SCROLLBUF_HT / 16)) == 0) return;
+	// Src (bloc dans la planche recopiée à la suite) et Dst.
+	pSrc = gMap.ppBlkTiles[nPlane] + (nBlockNo * BLK_TILE_PIX);
+	pDst = pBuf +
+		(((sBlMapY % (SCROLLBUF_HT / 16)) * 16) * nPitch) +
 		((sBlMapX % (SCROLLBUF_LG / 16)) * 16);
 	// Bloc.
 	for (k = 0; k < 16; k++)
 	{
-		*(u32 *)pDst = *(u32 *)pSrc;
-		*(u32 *)(pDst + 2) = *(u32 *)(pSrc + 2);
-		*(u32 *)(pDst + 4) = *(u32 *)(pSrc + 4);
-		*(u32 *)(pDst + 6) = *(u32 *)(pSrc + 6);
-		*(u32 *)(pDst + 8) = *(u32 *)(pSrc + 8);
-		*(u32 *)(pDst + 10) = *(u32 *)(pSrc + 10);
-		*(u32 *)(pDst + 12) = *(u32 *)(pSrc + 12);
-		*(u32 *)(pDst + 14) = *(u32 *)(pSrc + 14);
-		pSrc += gMap.ppPlanesGfx[nPlane]->w;
-		pDst += SCROLLBUF_LG;
+		memcpy(pDst, pSrc, 16 * sizeof(upix));	// Idem.
+		pSrc += 16;
+		pDst += nPitch;
 	}
 
-	SDL_UnlockSurface(gScrollM.ppPlanesScrollBuf[nPlane]);
-
 }
 
@@ -1,4 +1,5 @@
 
+#define	SCROLL_SPANS_ON	1	// 1 = Affichage des plans ligne  ligne (memcpy / couleur transparente SIMD) / 0 = SDL_BlitSurface.
 
 enum
 {
@@ -38,4 +39,6 @@ void ScrollDisplayPlane(u32 nPlaneNo);
 
 void ScrollGetPlanePosXY(s32 *pPosX, s32 *pPosY, u32 nPlane);
 void Scroll_BlkAnm_BlockUpdate(u32 nPlane, s32 sBlMapX, s32 sBlMapY, s32 nOffset);
+void ScrollRedraw(void);
+void ScrollSnapZones(void);
 
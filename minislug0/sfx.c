@@ -13,6 +13,9 @@ SDL_AudioDeviceID nDevId;
 
 	YMMUSIC *ppMusic[e_YmMusic_MAX];
 	s32	nMusicNo;	// e_YmMusic_NoMusic (-1) = Pas de musique.
+
+	Uint64	nMixTicks;	// Temps passé dans le mixer (profiler).
+	u32	nMixCalls;
 };
 struct SSfxGene	gSfx;
 
@@ -71,6 +74,9 @@ u32 Music_IsOver(void)
 // Mixer, appelé par SDL.
 void Sfx_MixAudio(void *unused, u8 *stream, int len)
 {
+#if PROF_ON == 1
+	Uint64	nMixStart = SDL_GetPerformanceCounter();
+#endif
     // Safety Check: Truncate if buffer is too small, don't just silence everything.
     int max_bytes = SFX_SAMPLES_CH * sizeof(s16);
     if (len > max_bytes) {
@@ -136,6 +142,17 @@ void Sfx_MixAudio(void *unused, u8 *stream, int len)
     }
 */
 
+#if PROF_ON == 1
+	gSfx.nMixTicks += SDL_GetPerformanceCounter() - nMixStart;
+	gSfx.nMixCalls++;
+#endif
+}
+
+// Temps passé dans le mixer depuis le lancement, en ticks du compteur haute résolution, et nb d'appels (profiler).
+void Sfx_MixStatsGet(Uint64 *pnTicks, u32 *pnCalls)
+{
+	*pnTicks = gSfx.nMixTicks;
+	*pnCalls = gSfx.nMixCalls;
 }
 
 #ifdef DEBUG_DISP
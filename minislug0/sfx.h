@@ -22,6 +22,7 @@ u32 Music_IsOver(void);
 
 void Sfx_SetVolume(s32 nVol);
 s32 Sfx_GetVolume(void);
+void Sfx_MixStatsGet(Uint64 *pnTicks, u32 *pnCalls);
 
 
 // Enum YM.
@@ -0,0 +1,388 @@
+
+// Snapshots de l'tat du jeu : Sauvegardes en mmoire et rembobinage.
+// Chaque module dclare ses zones mmoire (XxxSnapZones, appeles par SnapLevelStart). L'tat complet est la
+// concatnation de ces zones. Les pointeurs de fonction des monstres sont convertis en index (pack/unpack), les autres
+// pointeurs (anims, datas du niveau) sont gards tels quels : ils restent valides tant que le niveau est charg.
+//
+// Rembobinage : A chaque frame, l'tat est captur, xor avec celui de la frame prcdente, puis compact (RLE sur des
+// mots de 32 bits) dans une arne circulaire. Pour revenir en arrire, on xore l'tat prcdent avec le dernier delta.
+//
+// Format RLE : Suites de (u16 nb de mots nuls, u16 nb de mots littraux, mots littraux).
+
+#include "includes.h"
+
+struct SSnap	gSnap;
+
+extern u32	gnRndState;
+
+// Init (1 fois !).
+void SnapInit(void)
+{
+	memset(&gSnap, 0, sizeof(gSnap));
+}
+
+// Activation (option -snap). Sans arne, SnapLevelStart ne dclare rien et les snapshots ne cotent rien.
+void SnapEnable(void)
+{
+#if SNAP_ON == 1
+	if (gSnap.pArena != NULL) return;
+	if ((gSnap.pArena = (u8 *)malloc(SNAP_ARENA_SZ)) == NULL)
+	{
+		fprintf(stderr, "SnapEnable(): malloc failed.\n");
+		exit(1);
+	}
+#endif
+}
+
+// Release (1 fois !).
+void SnapRelease(void)
+{
+	SnapLevelEnd();
+	free(gSnap.pArena);
+	gSnap.pArena = NULL;
+}
+
+// Ajout d'une zone mmoire  l'tat.
+void SnapZoneAdd(void *pMem, u32 nSz, pSnapFct pFctPack, pSnapFct pFctUnpack)
+{
+	if (pMem == NULL || nSz == 0) return;
+	if (gSnap.nZonesNb >= SNAP_ZONES_MAX)
+	{
+		fprintf(stderr, "SnapZoneAdd(): Too many zones.\n");
+		exit(1);
+	}
+	gSnap.pZones[gSnap.nZonesNb].pMem = pMem;
+	gSnap.pZones[gSnap.nZonesNb].nSz = nSz;
+	gSnap.pZones[gSnap.nZonesNb].pFctPack = pFctPack;
+	gSnap.pZones[gSnap.nZonesNb].pFctUnpack = pFctUnpack;
+	gSnap.nZonesNb++;
+	gSnap.nRawSz += (nSz + SNAP_ALIGN - 1) & ~(SNAP_ALIGN - 1);
+}
+
+// RAZ du rembobinage.
+void Snap_sub_RingReset(void)
+{
+	gSnap.nRingHead = 0;
+	gSnap.nRingNb = 0;
+	gSnap.nArenaHead = 0;
+}
+
+// Capture de l'tat dans un buffer.
+void Snap_sub_Capture(u8 *pDst)
+{
+	u32	i;
+
+	for (i = 0; i < gSnap.nZonesNb; i++)
+	{
+		memcpy(pDst, gSnap.pZones[i].pMem, gSnap.pZones[i].nSz);
+		if (gSnap.pZones[i].pFctPack != NULL) gSnap.pZones[i].pFctPack(pDst);
+		pDst += (gSnap.pZones[i].nSz + SNAP_ALIGN - 1) & ~(SNAP_ALIGN - 1);
+	}
+}
+
+// Restauration de l'tat depuis un buffer (le buffer n'est pas modifi).
+void Snap_sub_Restore(u8 *pSrc)
+{
+	u32	i;
+	u8	*pDst;
+
+	memcpy(gSnap.pCur, pSrc, gSnap.nRawSz);
+	pDst = gSnap.pCur;
+	for (i = 0; i < gSnap.nZonesNb; i++)
+	{
+		if (gSnap.pZones[i].pFctUnpack != NULL) gSnap.pZones[i].pFctUnpack(pDst);
+		memcpy(gSnap.pZones[i].pMem, pDst, gSnap.pZones[i].nSz);
+		pDst += (gSnap.pZones[i].nSz + SNAP_ALIGN - 1) & ~(SNAP_ALIGN - 1);
+	}
+	// L'cran de scroll n'est pas dans l'tat, on le retrace.
+	ScrollRedraw();
+}
+
+// Compactage de pA ^ pB (pB == NULL : pA seul).
+// Out : Taille compacte, 0 si le buffer est trop petit.
+u32 Snap_sub_Pack(u32 *pA, u32 *pB, u32 nWords, u8 *pDst, u32 nMax)
+{
+	u32	i, nSz;
+	u32	nZero, nLit, nVal;
+	u16	*pHdr;
+
+	i = 0;
+	nSz = 0;
+	while (i < nWords)
+	{
+		// Mots nuls.
+		nZero = 0;
+		while (i < nWords && nZero < 0xFFFF && (pA[i] ^ (pB != NULL ? pB[i] : 0)) == 0) { i++; nZero++; }
+		// Mots littraux.
+		if (nSz + 4 > nMax) return (0);
+		pHdr = (u16 *)(pDst + nSz);
+		nSz += 4;
+		nLit = 0;
+		while (i < nWords && nLit < 0xFFFF && (nVal = pA[i] ^ (pB != NULL ? pB[i] : 0)) != 0)
+		{
+			if (nSz + 4 > nMax) return (0);
+			memcpy(pDst + nSz, &nVal, 4);
+			nSz += 4;
+			i++;
+			nLit++;
+		}
+		pHdr[0] = (u16)nZero;
+		pHdr[1] = (u16)nLit;
+	}
+	return (nSz);
+}
+
+// Dcompactage : pDst ^= datas.
+// Out : 1 = Ok / 0 = Datas incohrentes.
+u32 Snap_sub_Unpack(u8 *pSrc, u32 nSz, u32 *pDst, u32 nWords)
+{
+	u32	i, nPos;
+	u32	nLit, nVal;
+	u16	*pHdr;
+
+	i = 0;
+	nPos = 0;
+	while (nPos < nSz)
+	{
+		if (nPos + 4 > nSz) return (0);
+		pHdr = (u16 *)(pSrc + nPos);
+		nPos += 4;
+		i += pHdr[0];
+		nLit = pHdr[1];
+		if (i + nLit > nWords || nPos + (nLit * 4) > nSz) return (0);
+		for (; nLit; nLit--, nPos += 4)
+		{
+			memcpy(&nVal, pSrc + nPos, 4);
+			pDst[i++] ^= nVal;
+		}
+	}
+	return (i <= nWords);
+}
+
+// Rembobinage : L'entre la plus vieille occupe-t-elle la zone  crire ?
+// (Si on repart au dbut de l'arne, tout ce qui est aprs la tte est aussi perdu).
+u32 Snap_sub_RingOldestInWay(u32 nPos, u32 nSz, u32 nWrap)
+{
+	u32	nIdx;
+	u32	nOffs;
+
+	nIdx = (gSnap.nRingHead + SNAP_RING_FRAMES - gSnap.nRingNb) % SNAP_RING_FRAMES;
+	nOffs = gSnap.pnRingOffs[nIdx];
+	if (nWrap && nOffs >= gSnap.nArenaHead) return (1);
+	return (nOffs < nPos + nSz && nOffs + gSnap.pnRingSz[nIdx] > nPos);
+}
+
+// Rembobinage : Ajout d'un delta.
+void Snap_sub_RingPush(u8 *pSrc, u32 nSz)
+{
+	u32	nPos, nWrap;
+
+	if (nSz == 0 || nSz > SNAP_ARENA_SZ)
+	{
+		// Pas de place : L'historique est perdu.
+		Snap_sub_RingReset();
+		return;
+	}
+
+	nPos = gSnap.nArenaHead;
+	nWrap = 0;
+	if (nPos + nSz > SNAP_ARENA_SZ) { nPos = 0; nWrap = 1; }
+	// On libre la place (et une entre dans l'anneau si plein).
+	while (gSnap.nRingNb && (gSnap.nRingNb >= SNAP_RING_FRAMES || Snap_sub_RingOldestInWay(nPos, nSz, nWrap))) gSnap.nRingNb--;
+
+	memcpy(gSnap.pArena + nPos, pSrc, nSz);
+	gSnap.pnRingOffs[gSnap.nRingHead] = nPos;
+	gSnap.pnRingSz[gSnap.nRingHead] = nSz;
+	gSnap.nRingHead = (gSnap.nRingHead + 1) % SNAP_RING_FRAMES;
+	gSnap.nRingNb++;
+	gSnap.nArenaHead = (nPos + nSz + 3) & ~3;
+}
+
+// Fin de niveau : Plus de zones.
+void SnapLevelEnd(void)
+{
+	free(gSnap.pPrev);
+	free(gSnap.pCur);
+	free(gSnap.pTmp);
+	free(gSnap.pQuick);
+	gSnap.pPrev = gSnap.pCur = gSnap.pTmp = gSnap.pQuick = NULL;
+	gSnap.nQuickSz = 0;
+	gSnap.nZonesNb = 0;
+	gSnap.nRawSz = 0;
+	gSnap.nValid = 0;
+	Snap_sub_RingReset();
+}
+
+// Dbut de niveau : Dclaration des zones et allocation des buffers.
+// A appeler quand le niveau est charg et initialis.
+void SnapLevelStart(void)
+{
+#if SNAP_ON == 1
+	SnapLevelEnd();
+	if (gSnap.pArena == NULL) return;	// Snapshots pas activs.
+
+	GameSnapZones();
+	ScrollSnapZones();
+	LevelSnapZones();
+	AnmBlkSnapZones();
+	AnmSnapZones();
+	MstSnapZones();
+	Mst20SnapZones();
+	Mst30SnapZones();
+	Mst50SnapZones();
+	FireSnapZones();
+	DustSnapZones();
+	InterfaceSnapZones();
+	Transit2DSnapZones();
+	SnapZoneAdd(&gRogue, sizeof(gRogue), NULL, NULL);
+	SnapZoneAdd(&gnRndState, sizeof(gnRndState), NULL, NULL);
+	SnapZoneAdd(&gnFrame, sizeof(gnFrame), NULL, NULL);
+
+	// Pire cas du RLE : Un entte par mot littral.
+	gSnap.nTmpSz = (gSnap.nRawSz * 2) + 16;
+	gSnap.pPrev = (u8 *)calloc(gSnap.nRawSz, 1);	// calloc : Le padding entre les zones reste  0.
+	gSnap.pCur = (u8 *)calloc(gSnap.nRawSz, 1);
+	gSnap.pTmp = (u8 *)malloc(gSnap.nTmpSz);
+	if (gSnap.pPrev == NULL || gSnap.pCur == NULL || gSnap.pTmp == NULL)
+	{
+		fprintf(stderr, "SnapLevelStart(): malloc failed.\n");
+		exit(1);
+	}
+#endif
+}
+
+// Capture de la frame,  appeler  la fin de chaque frame de jeu.
+void SnapFrame(void)
+{
+	Uint64	nStart;
+	u8	*pSwap;
+	u32	nSz;
+
+	if (gSnap.nRawSz == 0) return;
+	nStart = SDL_GetPerformanceCounter();
+
+	Snap_sub_Capture(gSnap.pCur);
+	if (gSnap.nValid)
+	{
+		nSz = Snap_sub_Pack((u32 *)gSnap.pCur, (u32 *)gSnap.pPrev, gSnap.nRawSz / 4, gSnap.pTmp, gSnap.nTmpSz);
+		Snap_sub_RingPush(gSnap.pTmp, nSz);
+	}
+	pSwap = gSnap.pPrev;
+	gSnap.pPrev = gSnap.pCur;
+	gSnap.pCur = pSwap;
+	gSnap.nValid = 1;
+
+	gSnap.nLastTicks = SDL_GetPerformanceCounter() - nStart;
+}
+
+// Retour en arrire de nFrames frames (au maximum).
+// Out : Nb de frames rembobines.
+u32 SnapRewind(u32 nFrames)
+{
+	u32	i, nIdx;
+
+	if (gSnap.nValid == 0) return (0);
+
+	for (i = 0; i < nFrames && gSnap.nRingNb; i++)
+	{
+		nIdx = (gSnap.nRingHead + SNAP_RING_FRAMES - 1) % SNAP_RING_FRAMES;
+		if (Snap_sub_Unpack(gSnap.pArena + gSnap.pnRingOffs[nIdx], gSnap.pnRingSz[nIdx], (u32 *)gSnap.pPrev, gSnap.nRawSz / 4) == 0)
+		{
+			// Ne devrait pas arriver. pPrev est perdu.
+			fprintf(stderr, "SnapRewind(): Corrupted delta.\n");
+			Snap_sub_RingReset();
+			gSnap.nValid = 0;
+			return (0);
+		}
+		gSnap.nRingHead = nIdx;
+		gSnap.nRingNb--;
+		gSnap.nArenaHead = gSnap.pnRingOffs[nIdx];
+	}
+	if (i) Snap_sub_Restore(gSnap.pPrev);
+	return (i);
+}
+
+// Sauvegarde de l'tat courant.
+// Out : Buffer allou ( librer par l'appelant) ou NULL.
+u8 * SnapSave(u32 *pnSz)
+{
+	struct SSnapHdr	sHdr;
+	u8	*pBuf;
+	u32	nSz;
+
+	if (gSnap.nRawSz == 0) return (NULL);
+
+	Snap_sub_Capture(gSnap.pCur);
+	if ((nSz = Snap_sub_Pack((u32 *)gSnap.pCur, NULL, gSnap.nRawSz / 4, gSnap.pTmp, gSnap.nTmpSz)) == 0) return (NULL);
+	if ((pBuf = (u8 *)malloc(sizeof(struct SSnapHdr) + nSz)) == NULL)
+	{
+		fprintf(stderr, "SnapSave(): malloc failed.\n");
+		return (NULL);
+	}
+	memcpy(sHdr.pMagic, SNAP_MAGIC, 4);
+	sHdr.nRawSz = gSnap.nRawSz;
+	sHdr.nLevel = gGameVar.nLevel;
+	sHdr.nSz = nSz;
+	memcpy(pBuf, &sHdr, sizeof(struct SSnapHdr));
+	memcpy(pBuf + sizeof(struct SSnapHdr), gSnap.pTmp, nSz);
+	*pnSz = sizeof(struct SSnapHdr) + nSz;
+	return (pBuf);
+}
+
+// Chargement d'une sauvegarde, qui doit tre du niveau en cours.
+// Out : 1 = Ok / 0 = Sauvegarde refuse.
+u32 SnapLoad(u8 *pBuf, u32 nSz)
+{
+	struct SSnapHdr	sHdr;
+
+	if (gSnap.nRawSz == 0 || pBuf == NULL || nSz < sizeof(struct SSnapHdr)) return (0);
+	memcpy(&sHdr, pBuf, sizeof(struct SSnapHdr));
+	if (memcmp(sHdr.pMagic, SNAP_MAGIC, 4) != 0 || sHdr.nRawSz != gSnap.nRawSz ||
+		sHdr.nLevel != gGameVar.nLevel || sizeof(struct SSnapHdr) + sHdr.nSz != nSz)
+	{
+		fprintf(stderr, "SnapLoad(): Snapshot doesn't match the current level.\n");
+		return (0);
+	}
+
+	memset(gSnap.pCur, 0, gSnap.nRawSz);
+	if (Snap_sub_Unpack(pBuf + sizeof(struct SSnapHdr), sHdr.nSz, (u32 *)gSnap.pCur, gSnap.nRawSz / 4) == 0)
+	{
+		fprintf(stderr, "SnapLoad(): Corrupted snapshot.\n");
+		return (0);
+	}
+	// Les deltas ne s'appliquent plus  l'tat charg.
+	memcpy(gSnap.pPrev, gSnap.pCur, gSnap.nRawSz);
+	Snap_sub_RingReset();
+	gSnap.nValid = 1;
+	Snap_sub_Restore(gSnap.pPrev);
+	return (1);
+}
+
+// Touches : F7 = Sauvegarde rapide / F8 = Rechargement / F4 maintenu = Rembobinage.
+// Pas pendant l'enregistrement ou le rejeu d'une partie, les entres ne correspondraient plus.
+void SnapKeys(void)
+{
+	u8	*pBuf;
+	u32	nSz;
+
+	if (gSnap.nRawSz == 0 || gReplay.nActive) return;
+
+	if (gVar.pKeys[SDL_SCANCODE_F7])
+	{
+		if ((pBuf = SnapSave(&nSz)) != NULL)
+		{
+			free(gSnap.pQuick);
+			gSnap.pQuick = pBuf;
+			gSnap.nQuickSz = nSz;
+		}
+		gVar.pKeys[SDL_SCANCODE_F7] = 0;
+	}
+	if (gVar.pKeys[SDL_SCANCODE_F8])
+	{
+		if (gSnap.pQuick != NULL) SnapLoad(gSnap.pQuick, gSnap.nQuickSz);
+		gVar.pKeys[SDL_SCANCODE_F8] = 0;
+	}
+	// 2 frames en arrire, la frame en cours en rejoue une.
+	if (gVar.pKeys[SDL_SCANCODE_F4]) SnapRewind(2);
+}
+
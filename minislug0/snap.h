@@ -0,0 +1,68 @@
+
+// Snapshots de l'tat du jeu : Sauvegardes en mmoire et rembobinage.
+#define	SNAP_ON	1	// 1 = Snapshots compils, activs par l'option -snap (F7 sauve / F8 recharge / F4 maintenu rembobine) / 0 = Rien.
+
+#define	SNAP_RING_FRAMES	(70 * 10)	// Rembobinage : Nb de frames max (10 s  70 Hz).
+#define	SNAP_ARENA_SZ	(8 * 1024 * 1024)	// Rembobinage : Taille du buffer des deltas. Les plus vieux sont crass.
+#define	SNAP_MAGIC	"MSSN"
+
+typedef void (*pSnapFct)(u8 *pBuf);
+
+// Une zone mmoire de l'tat du jeu.
+struct SSnapZone
+{
+	void	*pMem;
+	u32	nSz;
+	pSnapFct	pFctPack;		// Optionnel : Conversion de la copie dans le snapshot (pointeurs > index...).
+	pSnapFct	pFctUnpack;		// Optionnel : Conversion inverse, avant recopie dans le jeu.
+};
+
+// Entte d'une sauvegarde (SnapSave).
+struct SSnapHdr
+{
+	char	pMagic[4];
+	u32	nRawSz;			// Taille de l'tat dcompact.
+	u32	nLevel;			// Niveau de la sauvegarde.
+	u32	nSz;			// Taille des datas compactes qui suivent.
+};
+
+#define	SNAP_ZONES_MAX	64
+#define	SNAP_ALIGN	8	// Alignement des zones dans l'tat (structures avec pointeurs).
+struct SSnap
+{
+	struct SSnapZone	pZones[SNAP_ZONES_MAX];
+	u32	nZonesNb;
+	u32	nRawSz;			// Taille de l'tat complet (zones alignes sur SNAP_ALIGN octets).
+	u8	*pPrev;			// Dernier tat captur (forme compacte : pointeurs convertis).
+	u8	*pCur;			// Buffer de travail.
+	u8	*pTmp;			// Delta compact, avant recopie dans l'arne.
+	u32	nTmpSz;
+	u8	nValid;			// pPrev valide ?
+	// Rembobinage : Deltas (XOR avec l'tat prcdent, puis RLE), du plus vieux au plus rcent.
+	u8	*pArena;
+	u32	pnRingOffs[SNAP_RING_FRAMES];
+	u32	pnRingSz[SNAP_RING_FRAMES];
+	u32	nRingHead;		// Prochaine entre crite.
+	u32	nRingNb;		// Nb d'entres valides.
+	u32	nArenaHead;		// Prochain octet crit dans l'arne.
+	// Sauvegarde rapide (F7/F8).
+	u8	*pQuick;
+	u32	nQuickSz;
+	// Stats.
+	Uint64	nLastTicks;		// Dure du dernier SnapFrame.
+};
+extern struct SSnap	gSnap;
+
+// Prototypes.
+void SnapInit(void);
+void SnapEnable(void);
+void SnapRelease(void);
+void SnapZoneAdd(void *pMem, u32 nSz, pSnapFct pFctPack, pSnapFct pFctUnpack);
+void SnapLevelStart(void);
+void SnapLevelEnd(void);
+void SnapFrame(void);
+u32 SnapRewind(u32 nFrames);
+u8 * SnapSave(u32 *pnSz);
+u32 SnapLoad(u8 *pBuf, u32 nSz);
+void SnapKeys(void);
+
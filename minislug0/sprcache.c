@@ -4,197 +4,240 @@
 
 #define	CACHE_DEBUG_INFO	0		// Mettre  0 pour ne pas afficher les infos de debug / 1 pour affichage.
 
-#define	CACHE_BIG_BLK_IDX	1//0		// 1 : avec gnCacheFreeLastBig.
-// Utile dans le cas de plusieurs allocs de blocs multiples dans la mme frame.
-// Ca acclre les recherche de gros blocs, mais a fragmente un peu plus.
-	// => A tester en conditions relles.
-
-extern	u16	*gpSprFlipBuf;	// Buffer pour crer les images flippes.
-
-
-#define	CACHE_BLK_SZ8	(32*32 * 2 * 2)		// Taille d'un bloc en bytes.
-#define	CACHE_BLK_SZ16	(CACHE_BLK_SZ8 / 2)	// Taille d'un bloc en words.
-#define	CACHE_BLK_NB	256//128//64//128//16//128		// Nb de blocs maxi dans le cache.
-
-u16	gpCacheData[CACHE_BLK_NB * CACHE_BLK_SZ16];	// Les blocs de datas dans la cache.
-u8	gpCacheFree[CACHE_BLK_NB];					// 0 = pos libre / x = pos occupe et nombre de cases  sauter pour la prochaine position (pleine ou vide).
-// ou faire un hachage pour taper directement  la pos x ?
-u32	gnCacheFreeLast;		// Pour acclrer la recherche des cases vides.
-#if CACHE_BIG_BLK_IDX == 1
-u32	gnCacheFreeLastBig;		// Pour acclrer la recherche des cases vides (gros blocs).
-#endif
-
-u32	gpLRU[CACHE_BLK_NB];	// Liste des sprites dans le cache. Buffer circulaire.
-u32	gnLRUNb;				// Nb de sprites dans la liste.
-u32	gnLRUIndex;				// Pos de dpart du buffer circulaire.
+extern	upix	*gpSprFlipBuf;	// Buffer pour crer les images flippes.
+
+
+// Allocation par classes de taille (slab) :
+// Le cache est un pool de blocs. Chaque sprite prend un "chunk" de n blocs, n tant arrondi  la classe de taille suprieure.
+// Chaque classe a sa liste de chunks libres et sa LRU : Allocation, hit et viction en O(1), pas de fragmentation.
+// Les chunks sont pris dans le pool au fur et  mesure (gnCacheBlkUsed), puis recycls dans leur classe.
+// Utilisateurs : CacheGetMem (sprites normaux, seulement avec SPRSPAN_ON  0 : sinon ils sont tracs en spans, sans
+// dpack) et CacheRZGetMem (roto/zooms, toujours).
+#define	CACHE_BLK_SZ8	(16*16 * 2 * sizeof(upix))	// Taille d'un bloc en bytes (gfx + masque au format cran).
+#define	CACHE_BLK_SZPIX	(CACHE_BLK_SZ8 / sizeof(upix))	// Taille d'un bloc en pixels.
+#define	CACHE_BLK_NB_DEF	1024		// Nb de blocs  la cration du pool (1 Mo).
+#define	CACHE_BLK_NB_INC	512			// Le pool grandit par x blocs quand une classe est  sec.
+#define	CACHE_BLK_NB_MAX	16384		// Taille max du pool (16 Mo).
+
+// Tailles des classes, en blocs. Progression ~x1.5 pour limiter la perte.
+#define	CACHE_CLASS_NB	19
+u16	gpCacheClassSz[CACHE_CLASS_NB] = { 1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768 };
+#define	CACHE_CLASS_BLK_MAX	768		// Au del, pas de cache.
+u8	gpCacheClassOf[CACHE_CLASS_BLK_MAX + 1];	// Nb de blocs > n de classe.
+
+upix	*gpCacheData;			// Le pool de blocs.
+u32	gnCacheBlkNb;			// Nb de blocs du pool (taille conserve d'un niveau  l'autre).
+u32	gnCacheBlkUsed;			// Nb de blocs dj dcoups en chunks.
+s32	*gpCacheChunkNext;		// Chanage des chunks libres (index par n du premier bloc).
+s32	gpCacheFreeList[CACHE_CLASS_NB];	// Premier chunk libre de chaque classe, -1 si aucun.
+
+u32	gnCacheFrame;			// N de frame, pour l'age des sprites.
 
 struct SSprCache
 {
-	s16	nPos;		// -1 = pas dans le cache / sinon index dans le cache.
-	u16	nBlocksNb;	// Nb de blocs utiliss.
-	u16	nLRUPos;	// Pos dans le LRU.
-	u16	nAge;		// Anciennet dans la liste.
+	s32	nPos;		// -1 = pas dans le cache / sinon n du premier bloc.
+	s32	nPrev, nNext;	// LRU de la classe (double chanage, -1 en bout de liste). Prev = plus rcent / Next = plus vieux.
+	u32	nFrame;		// Frame de dernire utilisation.
+	u8	nClass;		// Classe de taille.
 };
 struct SSprCache	gpSprUse[e_Spr_NEXT * 4];	// Normal / flip y / flip x / flip xy.
 
-//=============================================================================
+u32	gnCacheBlkLive;			// Nb de blocs occups par des sprites.
 
-// On met  jour la LRU.
-// nSprNo devient le plus rcent sprite utilis.
-void LRUUpdate(u32 nSprNo)
-{
-	u32	i;
-
-// todo : on doit pouvoir simplifier tous les (gnLRUIndex + i) et utiliser directement le n de la case.
+struct SCacheStats	gCacheStatsCur;		// Frame en cours.
+struct SCacheStats	gCacheStatsFrame;	// Dernire frame complte.
+struct SCacheStats	gCacheStatsLevel;	// Cumul du niveau en cours.
+u32	gnCacheStatsLevelNo;
+u8	gnCacheStatsCsv;
 
+s32	gpLRUHead[CACHE_CLASS_NB];	// Sprite le plus rcent de chaque classe.
+s32	gpLRUTail[CACHE_CLASS_NB];	// Sprite le plus vieux de chaque classe.
 
-if (nSprNo != gpLRU[gpSprUse[nSprNo].nLRUPos]) { fprintf(stderr, "LRUUpdate: PROBLEM!!! nSprNo=%d / gpSprUse[nSprNo].nLRUPos=%d / gpLRU[gpSprUse[nSprNo].nLRUPos]=%d\n", (int)nSprNo, (int)gpSprUse[nSprNo].nLRUPos, (int)gpLRU[gpSprUse[nSprNo].nLRUPos]); return; }	// debug.
+#if CACHE_RZ_ON == 1
+// Cache des sprites roto/zooms. Clef : n de sprite + flips, type de rendu (zoom ou rotozoom), zoom x, zoom y (ou angle).
+// Les chunks sont pris dans les classes du pool, comme les sprites normaux (avec SPRSPAN_ON, c'est le seul utilisateur
+// du pool). Ils ne sont pas dans les LRU des classes : Seul l'ge les libre, le nb de slots borne leur place dans le pool.
+#define	CACHE_RZ_SLOTS_NB	32		// Nb max de roto/zooms dans le cache.
+#define	CACHE_RZ_AGE_MAX	16		// Age limite (en frames). Plus long que pour les sprites normaux, un tir  tte chercheuse garde le mme angle un moment.
 
+struct SSprCacheRZ
+{
+	u32	nSprNo;		// N du sprite + flips.
+	void	*pFct;		// Fct de rendu (zoom ou rotozoom).
+	u16	nZoomX, nZoomY;	// Zoom x / zoom y ou angle.
+	s32	nPos;		// -1 = slot libre / sinon n du premier bloc du chunk.
+	u8	nClass;		// Classe de taille du chunk.
+	u16	nAge;		// Anciennet.
+};
+struct SSprCacheRZ	gpCacheRZ[CACHE_RZ_SLOTS_NB];
+#endif
 
-	i = gpSprUse[nSprNo].nLRUPos;
-	i = (i - gnLRUIndex) & (CACHE_BLK_NB - 1);
+//=============================================================================
 
-	if (i < gnLRUNb / 2)
-	{
-		// Dans les plus vieux. > Le plus vieux sprite de la liste prend la position du sprite a updater, et le sprite a updater passe en tte en devenant le plus rcent.
-		// 1 - "Swap" avec le dernier. (En fait on n'a pas besoin de copier le nouveau  la fin, puisqu'on va avancer la position de dpart).
-		gpLRU[(gnLRUIndex + i) & (CACHE_BLK_NB - 1)] = gpLRU[gnLRUIndex];
-		gpSprUse[gpLRU[gnLRUIndex]].nLRUPos = (gnLRUIndex + i) & (CACHE_BLK_NB - 1);	// Nouvel index ancien sprite swapp (valeur dans la case originale encore valide).
-		// 2 - Ajout du spr en dbut de liste.
-		gpLRU[(gnLRUIndex + gnLRUNb) & (CACHE_BLK_NB - 1)] = nSprNo;
-		gpSprUse[nSprNo].nLRUPos = (gnLRUIndex + gnLRUNb) & (CACHE_BLK_NB - 1);			// Nouvel index du sprite qu'on replace en tte.
-		gpSprUse[nSprNo].nAge = 0;			// RAZ age.
-		//
-		gnLRUIndex = (gnLRUIndex + 1) & (CACHE_BLK_NB - 1);	// ...et on dcale la liste dans le buffer circulaire.
-	}
-	else
-	{
-		// Dans les plus rcents.
-		// Swap avec le premier.
-		gpLRU[(gnLRUIndex + i) & (CACHE_BLK_NB - 1)] = gpLRU[(gnLRUIndex + gnLRUNb - 1) & (CACHE_BLK_NB - 1)];
-		gpSprUse[gpLRU[(gnLRUIndex + i) & (CACHE_BLK_NB - 1)]].nLRUPos = (gnLRUIndex + i) & (CACHE_BLK_NB - 1);		// Nouvel index du sprite qu'on swappe.
-		//
-		gpLRU[(gnLRUIndex + gnLRUNb - 1) & (CACHE_BLK_NB - 1)] = nSprNo;
-		gpSprUse[nSprNo].nLRUPos = (gnLRUIndex + gnLRUNb - 1) & (CACHE_BLK_NB - 1);			// Nouvel index du sprite qu'on replace en tte.
-		gpSprUse[nSprNo].nAge = 0;			// RAZ age.
-	}
+// Retire un sprite de la LRU de sa classe.
+void LRUUnlink(u32 nSprNo)
+{
+	struct SSprCache	*pUse = &gpSprUse[nSprNo];
 
+	if (pUse->nPrev != -1) gpSprUse[pUse->nPrev].nNext = pUse->nNext; else gpLRUHead[pUse->nClass] = pUse->nNext;
+	if (pUse->nNext != -1) gpSprUse[pUse->nNext].nPrev = pUse->nPrev; else gpLRUTail[pUse->nClass] = pUse->nPrev;
 }
 
-// Ajoute un lment  la liste (donc au bout).
-void LRUNew(u32 nSprNo)
+// Ajoute un sprite en tte de la LRU de sa classe (le plus rcent).
+void LRUPushHead(u32 nSprNo)
 {
-	gpLRU[(gnLRUIndex + gnLRUNb) & (CACHE_BLK_NB - 1)] = nSprNo;
-	gpSprUse[nSprNo].nLRUPos = (gnLRUIndex + gnLRUNb) & (CACHE_BLK_NB - 1);
-	gpSprUse[nSprNo].nAge = 0;			// RAZ age.
-	gnLRUNb++;
-//printf("gnLRUNb=%d\n", (int)gnLRUNb);		// normalement, a ne doit pas dborder (nb max dans la liste est <= au nombre de spr max, puisque tous prennent au moins 1 bloc).
+	struct SSprCache	*pUse = &gpSprUse[nSprNo];
+
+	pUse->nPrev = -1;
+	pUse->nNext = gpLRUHead[pUse->nClass];
+	if (pUse->nNext != -1) gpSprUse[pUse->nNext].nPrev = nSprNo; else gpLRUTail[pUse->nClass] = nSprNo;
+	gpLRUHead[pUse->nClass] = nSprNo;
+	pUse->nFrame = gnCacheFrame;
 }
 
-// Supprime le premier lment de la liste.
-void LRUDeleteFirst(void)
+// On met  jour la LRU.
+// nSprNo devient le plus rcent sprite utilis.
+void LRUUpdate(u32 nSprNo)
 {
-	gnLRUNb--;
-	gnLRUIndex = (gnLRUIndex + 1) & (CACHE_BLK_NB - 1);
+	if (gpLRUHead[gpSprUse[nSprNo].nClass] == (s32)nSprNo)
+	{
+		gpSprUse[nSprNo].nFrame = gnCacheFrame;		// Dj en tte.
+		return;
+	}
+	LRUUnlink(nSprNo);
+	LRUPushHead(nSprNo);
 }
 
 //=============================================================================
 
-// Remise  zro du cache.
-void CacheClear(void)
+// Redimensionne le pool. Le contenu n'a pas  tre conserv (uniquement appel sur un cache vide ou pour l'agrandir).
+// Out : 0 = Ok / 1 = Echec (le pool garde sa taille).
+u32 Cache_sub_PoolResize(u32 nBlkNb)
 {
-	u32	i;
-
-	for (i = 0; i < CACHE_BLK_NB; i++) gpCacheFree[i] = 0;
-	gnCacheFreeLast = 0;
-#if CACHE_BIG_BLK_IDX == 1
-	gnCacheFreeLastBig = 0;
+	upix	*pData;
+	s32	*pNext;
+
+	if ((pData = (upix *)realloc(gpCacheData, nBlkNb * CACHE_BLK_SZ8)) == NULL) return (1);
+	gpCacheData = pData;
+	if ((pNext = (s32 *)realloc(gpCacheChunkNext, nBlkNb * sizeof(s32))) == NULL) return (1);
+	gpCacheChunkNext = pNext;
+	gnCacheBlkNb = nBlkNb;
+#ifdef DEBUG_INFO
+printf("Cache: Pool size = %d blocks (%d KB).\n", (int)gnCacheBlkNb, (int)(gnCacheBlkNb * CACHE_BLK_SZ8 / 1024));
 #endif
-	gnLRUNb = 0;		// Nb de sprites dans la liste.
-	gnLRUIndex = 0;		// Pos de dpart du buffer circulaire.
-	for (i = 0; i < e_Spr_NEXT * 4; i++) gpSprUse[i].nPos = -1;
-
+	return (0);
 }
 
-// Renvoie la position de la premire case  partir de laquelle x blocs sont libres.
-// -1 si pas d'espace assez grand.
-s32 CacheGetFreeBlocks(u32 nNbBlocsReq)
+// Remise  zro du cache.
+// La taille du pool est conserve : Elle s'est cale sur le niveau le plus gourmand vu jusque l.
+void CacheClear(void)
 {
 	u32	i, j;
 
-#if CACHE_DEBUG_INFO == 1
-u32	k=0;
-printf("gpCacheFree:");
-for (i = 0; i < CACHE_BLK_NB; i++) printf("%d", (int)gpCacheFree[i]);
-printf("\n");
-#endif
-
-////	for (i = gnCacheFreeLast; i < CACHE_BLK_NB; i++)
-//	for (i = gnCacheFreeLast; i < CACHE_BLK_NB; )//i++)
-#if CACHE_BIG_BLK_IDX == 1
-	for (i = (nNbBlocsReq == 1 ? gnCacheFreeLast : gnCacheFreeLastBig); i < CACHE_BLK_NB; )
-#else
-	for (i = gnCacheFreeLast; i < CACHE_BLK_NB; )//i++)
-#endif
+	if (gpCacheData == NULL)
 	{
-		// Case vide ?
-		if (gpCacheFree[i] == 0)
+		// Premier appel : Table des classes et pool initial.
+		for (i = 0, j = 0; i <= CACHE_CLASS_BLK_MAX; i++)
 		{
-			// Oui, y-a-t'il assez de cases ?
-			for (j = 0; (j < nNbBlocsReq) && (i + j < CACHE_BLK_NB); j++)
-			{
-#if CACHE_DEBUG_INFO == 1
-k++;
-#endif
-				if (gpCacheFree[i + j]) break;
-			}
-//			if (j == nNbBlocsReq) return (i);
-			if (j == nNbBlocsReq)
-			{
-#if CACHE_DEBUG_INFO == 1
-printf("CacheGetFreeBlocks / found - loops: %d\n", (int)k);
-#endif
-				return (i);
-			}
-			i += j;		// Non, tant qu' faire on saute par dessus l'espace vide test.
+			if (i > gpCacheClassSz[j]) j++;
+			gpCacheClassOf[i] = j;
+		}
+		if (Cache_sub_PoolResize(CACHE_BLK_NB_DEF))
+		{
+			fprintf(stderr, "CacheClear(): malloc failed.\n");
+			exit(1);
 		}
-		//else			// Pas besoin du else, la recherche prcdente s'arrte sur une case pleine ! Donc autant skipper tout de suite.
-			i += gpCacheFree[i];	// Skippe le nombre de cases pleines.
-#if CACHE_DEBUG_INFO == 1
-k++;
-#endif
 	}
-#if CACHE_DEBUG_INFO == 1
-printf("CacheGetFreeBlocks / not found - loops: %d\n", (int)k);
+
+	gnCacheBlkUsed = 0;
+	gnCacheBlkLive = 0;
+	for (i = 0; i < CACHE_CLASS_NB; i++)
+	{
+		gpCacheFreeList[i] = -1;
+		gpLRUHead[i] = gpLRUTail[i] = -1;
+	}
+	for (i = 0; i < e_Spr_NEXT * 4; i++) gpSprUse[i].nPos = -1;
+
+#if CACHE_RZ_ON == 1
+	for (i = 0; i < CACHE_RZ_SLOTS_NB; i++) gpCacheRZ[i].nPos = -1;
 #endif
-	return (-1);
+
 }
 
-// Supprime le plus vieil lment du cache (enfin, le premier de la LRU).
-void CacheDeleteFirst(void)
+// Libration du pool (1 fois !).
+void CacheRelease(void)
 {
-	u32	nRem;
-	u32	i;
+	free(gpCacheData);
+	free(gpCacheChunkNext);
+	gpCacheData = NULL;
+	gpCacheChunkNext = NULL;
+	gnCacheBlkNb = 0;
+}
 
-	if (gnLRUNb == 0) return;
-	nRem = gpLRU[gnLRUIndex];	// On rcupre le n du sprite  retirer.
-	LRUDeleteFirst();			// Suppression de la LRU.
-	// Libre les cases de gpCacheFree
-	for (i = gpSprUse[nRem].nPos; i < gpSprUse[nRem].nPos + gpSprUse[nRem].nBlocksNb; i++) gpCacheFree[i] = 0;
-	if (gpSprUse[nRem].nPos < gnCacheFreeLast) gnCacheFreeLast = gpSprUse[nRem].nPos;	// Pour acclrer la recherche de cases vides.
-#if CACHE_BIG_BLK_IDX == 1
-	if (gpSprUse[nRem].nPos < gnCacheFreeLastBig) gnCacheFreeLastBig = gpSprUse[nRem].nPos;	// Pour acclrer la recherche de cases vides.
-#endif
-	gpSprUse[nRem].nPos = -1;	// RAZ index.
+// Supprime un sprite du cache, son chunk retourne dans la liste libre de sa classe.
+void CacheDelete(u32 nSprNo)
+{
+	struct SSprCache	*pUse = &gpSprUse[nSprNo];
+
+	LRUUnlink(nSprNo);
+	gnCacheBlkLive -= gpCacheClassSz[pUse->nClass];
+	gpCacheChunkNext[pUse->nPos] = gpCacheFreeList[pUse->nClass];
+	gpCacheFreeList[pUse->nClass] = pUse->nPos;
+	pUse->nPos = -1;
+}
+
+// Rcupre un chunk libre d'une classe.
+// -1 si rien de dispo.
+s32 Cache_sub_ChunkGet(u32 nClass)
+{
+	s32	nPos, nSprNo;
+	u32	nNewSz;
+	u32	nBlkNb = gpCacheClassSz[nClass];
+
+	// 1 - Un chunk libre dans la classe ?
+	if ((nPos = gpCacheFreeList[nClass]) != -1)
+	{
+		gpCacheFreeList[nClass] = gpCacheChunkNext[nPos];
+		return (nPos);
+	}
+	// 2 - De la place dans le pool ?
+	if (gnCacheBlkUsed + nBlkNb <= gnCacheBlkNb)
+	{
+		nPos = gnCacheBlkUsed;
+		gnCacheBlkUsed += nBlkNb;
+		return (nPos);
+	}
+	// 3 - Un sprite de la classe qui n'a pas servi dans cette frame ? On prend sa place.
+	if ((nSprNo = gpLRUTail[nClass]) != -1 && gpSprUse[nSprNo].nFrame != gnCacheFrame)
+		goto _Evict;
+	// 4 - On agrandit le pool.
+	for (nNewSz = gnCacheBlkNb + CACHE_BLK_NB_INC; nNewSz < gnCacheBlkUsed + nBlkNb; nNewSz += CACHE_BLK_NB_INC);
+	if (nNewSz <= CACHE_BLK_NB_MAX && Cache_sub_PoolResize(nNewSz) == 0)
+	{
+		nPos = gnCacheBlkUsed;
+		gnCacheBlkUsed += nBlkNb;
+		return (nPos);
+	}
+	// 5 - En dernier recours, le plus vieux de la classe, mme utilis dans la frame (il a dj t affich).
+	if ((nSprNo = gpLRUTail[nClass]) != -1)
+		goto _Evict;
+	return (-1);
 
+_Evict:
+	nPos = gpSprUse[nSprNo].nPos;
+	LRUUnlink(nSprNo);
+	gpSprUse[nSprNo].nPos = -1;
+	gnCacheBlkLive -= nBlkNb;
+	gCacheStatsCur.nEvictions++;
+	return (nPos);
 }
 
 // Demande un espace mmoire au cache.
-u32 CacheGetMem(u32 nSprNo, u32 nSprSz, u16 **ppGfx)
+// Note : Le pointeur renvoy n'est valable que jusqu'au prochain appel (le pool peut tre rallou).
+u32 CacheGetMem(u32 nSprNo, u32 nSprSz, upix **ppGfx)
 {
-	u32	nNbBlocsReq;
+	u32	nNbBlocsReq, nClass;
 	s32	nPos;
-	u32	i;
 
 	nSprNo = ((nSprNo & ~(SPR_Flip_X | SPR_Flip_Y | SPR_Flag_HitPal)) * 4) + ((nSprNo >> 30) & 3);	// (sprno * 4) + index [0-3] en fct du flip.
 
@@ -203,104 +246,224 @@ u32 CacheGetMem(u32 nSprNo, u32 nSprSz, u16 **ppGfx)
 	{
 		// Oui.
 #if CACHE_DEBUG_INFO == 1
-//printf("spr #%d / cache hit\n", (int)nSprNo);
 printf("spr #%d/%d / cache hit\n", (int)nSprNo>>2, (int)nSprNo&3);
 #endif
 		LRUUpdate(nSprNo);
-		*ppGfx = &gpCacheData[gpSprUse[nSprNo].nPos * CACHE_BLK_SZ16];
+		*ppGfx = &gpCacheData[gpSprUse[nSprNo].nPos * CACHE_BLK_SZPIX];
+		gCacheStatsCur.nHits++;
 		return (e_Cache_Hit);
 	}
 
-	// Non.
-#if CACHE_DEBUG_INFO == 1
-//printf("spr #%d / cache miss\n", (int)nSprNo);
-//printf("spr #%d / cache miss", (int)nSprNo);
-printf("spr #%d/%d / cache miss", (int)nSprNo>>2, (int)nSprNo&3);
-#endif
-
-	// Nb de blocs requis.
-	nNbBlocsReq = (nSprSz * 2 * 2) / CACHE_BLK_SZ8;	// nSprSz * 2 => Pour taille du gfx + taille du masque / * 2 pour taille u16.
-	if ((nSprSz * 2) & (CACHE_BLK_SZ8 - 1)) nNbBlocsReq++;
+	// Non. Nb de blocs requis : nSprSz * 2 => Pour taille du gfx + taille du masque / * sizeof(upix) pour la taille en bytes.
+	gCacheStatsCur.nMisses++;
+	gCacheStatsCur.nBytesUnpacked += nSprSz * 2 * sizeof(upix);
+	nNbBlocsReq = (nSprSz * 2 * sizeof(upix) + CACHE_BLK_SZ8 - 1) / CACHE_BLK_SZ8;
+	nClass = (nNbBlocsReq > CACHE_CLASS_BLK_MAX ? 0 : gpCacheClassOf[nNbBlocsReq]);
 
 #if CACHE_DEBUG_INFO == 1
-printf(" / sprsz: %d / nb blk req: %d\n", (int)nSprSz, (int)nNbBlocsReq);
+printf("spr #%d/%d / cache miss / sprsz: %d / nb blk req: %d / class: %d\n", (int)nSprNo>>2, (int)nSprNo&3, (int)nSprSz, (int)nNbBlocsReq, (int)nClass);
 #endif
 
-	// On va chercher uns position libre.
-	if ((nPos = CacheGetFreeBlocks(nNbBlocsReq)) < 0)
+	if (nNbBlocsReq > CACHE_CLASS_BLK_MAX || (nPos = Cache_sub_ChunkGet(nClass)) < 0)
 	{
-		fprintf(stderr, "Cache alarm: cache full!\n");
+		// Message seulement la premire fois dans le niveau, les suivantes sont comptes dans les stats (nFallbacks).
+		if (gCacheStatsLevel.nFallbacks + gCacheStatsCur.nFallbacks == 0)
+			fprintf(stderr, "Cache alarm: cache full! (Next fallbacks of the level are only counted in the cache stats).\n");
 		// Plus de place, tant pis, on va tracer dans le buffer en direct.
 		*ppGfx = gpSprFlipBuf;
+		gCacheStatsCur.nFallbacks++;
 		return (e_Cache_Miss);
 	}
 
-	LRUNew(nSprNo);
 	gpSprUse[nSprNo].nPos = nPos;
-	gpSprUse[nSprNo].nBlocksNb = nNbBlocsReq;
-	// Marque les blocs utiliss.
-//	for (i = 0; i < nNbBlocsReq; i++) gpCacheFree[nPos + i] = 1;
-	for (i = 0; i < nNbBlocsReq; i++) gpCacheFree[nPos + i] = nNbBlocsReq - i;	// Marquage type 6 5 4 3 2 1.
-/*
-	if (nNbBlocsReq == 1) gnCacheFreeLast = nPos + 1;//nNbBlocsReq;	// La prochaine recherche de blocs vides commencera  la position suivante (update seulement si 1 case demande, sinon on peut sauter des cases vides et on y reviendra jamais).
-#if CACHE_BIG_BLK_IDX == 1
-	gnCacheFreeLastBig = nPos + nNbBlocsReq;
-#endif
-*/
-	// Mini optim : En plus, on ajoute l'offset de la position suivante (0 ou x), pour possiblement gagner une itration lors des recherches.
-	if (nNbBlocsReq == 1) gnCacheFreeLast = nPos + 1 + gpCacheFree[nPos + 1];	// La prochaine recherche de blocs vides commencera  la position suivante (update seulement si 1 case demande, sinon on peut sauter des cases vides et on y reviendra jamais).
-#if CACHE_BIG_BLK_IDX == 1
-	gnCacheFreeLastBig = nPos + nNbBlocsReq + gpCacheFree[nPos + nNbBlocsReq];
-#endif
+	gpSprUse[nSprNo].nClass = nClass;
+	gnCacheBlkLive += gpCacheClassSz[nClass];
+	LRUPushHead(nSprNo);
+
+	*ppGfx = &gpCacheData[nPos * CACHE_BLK_SZPIX];
+	return (e_Cache_Miss);
+}
 
-	*ppGfx = &gpCacheData[nPos * CACHE_BLK_SZ16];
+//=============================================================================
 
+#if CACHE_RZ_ON == 1
+// Libre un slot du cache des roto/zooms, son chunk retourne dans la liste libre de sa classe.
+void CacheRZ_sub_Free(struct SSprCacheRZ *pSlot)
+{
+	gnCacheBlkLive -= gpCacheClassSz[pSlot->nClass];
+	gpCacheChunkNext[pSlot->nPos] = gpCacheFreeList[pSlot->nClass];
+	gpCacheFreeList[pSlot->nClass] = pSlot->nPos;
+	pSlot->nPos = -1;
+}
+
+// Demande un espace mmoire au cache des roto/zooms.
+// Comme CacheGetMem, mais avec la clef complte du rendu. En cas de hit, pas besoin de refaire le rendu ni le dpack.
+// Note : Le pointeur renvoy n'est valable que jusqu'au prochain appel (le pool peut tre rallou).
+u32 CacheRZGetMem(u32 nSprNo, void *pFct, u16 nZoomX, u16 nZoomY, u32 nSprSz, upix **ppGfx)
+{
+	u32	nNbBlocsReq, nClass;
+	s32	nPos;
+	u32	i;
+	struct SSprCacheRZ	*pSlot, *pOldest;
+
+	nSprNo &= ~SPR_Flag_HitPal;		// Le hit est gr  l'affichage.
+
+	// Dj dans le cache ?
+	for (i = 0; i < CACHE_RZ_SLOTS_NB; i++)
+	{
+		pSlot = &gpCacheRZ[i];
+		if (pSlot->nPos != -1 && pSlot->nSprNo == nSprNo && pSlot->pFct == pFct && pSlot->nZoomX == nZoomX && pSlot->nZoomY == nZoomY)
+		{
+			pSlot->nAge = 0;
+			*ppGfx = &gpCacheData[pSlot->nPos * CACHE_BLK_SZPIX];
+			gCacheStatsCur.nRZHits++;
+			return (e_Cache_Hit);
+		}
+	}
+
+	// Non. Nb de blocs requis (gfx + masque, en upix).
+	gCacheStatsCur.nRZMisses++;
+	gCacheStatsCur.nBytesUnpacked += nSprSz * 2 * sizeof(upix);
+	nNbBlocsReq = (nSprSz * 2 * sizeof(upix) + CACHE_BLK_SZ8 - 1) / CACHE_BLK_SZ8;
+	*ppGfx = gpSprFlipBuf;		// Par dfaut, rendu dans le buffer, sans cache.
+	if (nNbBlocsReq > CACHE_CLASS_BLK_MAX) return (e_Cache_Miss);
+	nClass = gpCacheClassOf[nNbBlocsReq];
+
+	// Recherche d'un slot. S'il n'y en a plus, on vire le plus vieux.
+	pSlot = NULL;
+	pOldest = NULL;
+	for (i = 0; i < CACHE_RZ_SLOTS_NB; i++)
+	{
+		if (gpCacheRZ[i].nPos == -1)
+		{
+			if (pSlot == NULL) pSlot = &gpCacheRZ[i];
+		}
+		else if (gpCacheRZ[i].nAge && (pOldest == NULL || gpCacheRZ[i].nAge > pOldest->nAge))
+			pOldest = &gpCacheRZ[i];	// Age 0 = utilis dans la frame, on ne le vire pas.
+	}
+	if (pSlot == NULL)
+	{
+		if (pOldest == NULL) return (e_Cache_Miss);		// Plus rien  virer, tant pis, pas de cache.
+		CacheRZ_sub_Free(pOldest);
+		pSlot = pOldest;
+	}
+	// Un chunk de la classe (liste libre, pool, ou place d'un sprite normal).
+	if ((nPos = Cache_sub_ChunkGet(nClass)) < 0) return (e_Cache_Miss);
+
+	pSlot->nSprNo = nSprNo;
+	pSlot->pFct = pFct;
+	pSlot->nZoomX = nZoomX;
+	pSlot->nZoomY = nZoomY;
+	pSlot->nPos = nPos;
+	pSlot->nClass = nClass;
+	pSlot->nAge = 0;
+	gnCacheBlkLive += gpCacheClassSz[nClass];
+
+	*ppGfx = &gpCacheData[nPos * CACHE_BLK_SZPIX];
 	return (e_Cache_Miss);
 }
 
+// Nettoyage des roto/zooms trop anciens.
+void CacheRZ_sub_ClearOld(void)
+{
+	u32	i;
+
+	for (i = 0; i < CACHE_RZ_SLOTS_NB; i++)
+		if (gpCacheRZ[i].nPos != -1 && ++gpCacheRZ[i].nAge > CACHE_RZ_AGE_MAX)
+			CacheRZ_sub_Free(&gpCacheRZ[i]);
+}
+#endif
+
 //=============================================================================
 
 #define	CACHE_AGE_MAX	1//2//4//8//32//8//32//16//32		// Age limite dans le buffer.
 // Il y a normement de sprites dans les anims et ils restent peu de temps. Il faut donc les discarder trs vite.
 // Le but tant simplement de ne pas dpacker et gnrer un masque pour des sprites x frames d'affile, voire x fois par frame (balles de mitrailleuse).
 
+// Stats : Fin de frame. La frame en cours devient la dernire frame complte, et s'ajoute au cumul du niveau.
+void Cache_sub_StatsFrameEnd(void)
+{
+	gCacheStatsCur.nFrames = 1;
+	gCacheStatsCur.nLiveBlks = gnCacheBlkLive;
+	gCacheStatsCur.nPoolBlks = gnCacheBlkNb;
+	gCacheStatsFrame = gCacheStatsCur;
+
+	gCacheStatsLevel.nFrames++;
+	gCacheStatsLevel.nHits += gCacheStatsCur.nHits;
+	gCacheStatsLevel.nMisses += gCacheStatsCur.nMisses;
+	gCacheStatsLevel.nEvictions += gCacheStatsCur.nEvictions;
+	gCacheStatsLevel.nExpired += gCacheStatsCur.nExpired;
+	gCacheStatsLevel.nFallbacks += gCacheStatsCur.nFallbacks;
+	gCacheStatsLevel.nRZHits += gCacheStatsCur.nRZHits;
+	gCacheStatsLevel.nRZMisses += gCacheStatsCur.nRZMisses;
+	gCacheStatsLevel.nBytesUnpacked += gCacheStatsCur.nBytesUnpacked;
+	if (gCacheStatsCur.nLiveBlks > gCacheStatsLevel.nLiveBlks) gCacheStatsLevel.nLiveBlks = gCacheStatsCur.nLiveBlks;
+	if (gCacheStatsCur.nPoolBlks > gCacheStatsLevel.nPoolBlks) gCacheStatsLevel.nPoolBlks = gCacheStatsCur.nPoolBlks;
+
+	memset(&gCacheStatsCur, 0, sizeof(struct SCacheStats));
+}
+
+// Lecture des stats (dernire frame complte et cumul du niveau). Pointeurs NULL accepts.
+void CacheStatsGet(struct SCacheStats *pFrame, struct SCacheStats *pLevel)
+{
+	if (pFrame != NULL) *pFrame = gCacheStatsFrame;
+	if (pLevel != NULL) *pLevel = gCacheStatsLevel;
+}
+
+// Stats : Dbut de niveau.
+void CacheStatsLevelStart(u32 nLevelNo)
+{
+	gnCacheStatsLevelNo = nLevelNo;
+	memset(&gCacheStatsLevel, 0, sizeof(struct SCacheStats));
+}
+
+// Stats : Fin de niveau. Ajoute une ligne au fichier CSV.
+void CacheStatsLevelEnd(void)
+{
+	FILE	*pFile;
+	struct SCacheStats	*pSt = &gCacheStatsLevel;
+
+	if (gnCacheStatsCsv == 0 || pSt->nFrames == 0) return;
+	if ((pFile = fopen(CACHE_STATS_FILENAME, "a")) == NULL)
+	{
+		fprintf(stderr, "CacheStatsLevelEnd(): Unable to open '%s'.\n", CACHE_STATS_FILENAME);
+		return;
+	}
+	if (ftell(pFile) == 0)
+		fprintf(pFile, "level;frames;hits;misses;evictions;expired;fallbacks;rz_hits;rz_misses;bytes_unpacked;live_blocks_max;pool_blocks_max;block_size\n");
+	fprintf(pFile, "%d;%d;%d;%d;%d;%d;%d;%d;%d;%.0f;%d;%d;%d\n", (int)gnCacheStatsLevelNo, (int)pSt->nFrames,
+		(int)pSt->nHits, (int)pSt->nMisses, (int)pSt->nEvictions, (int)pSt->nExpired, (int)pSt->nFallbacks,
+		(int)pSt->nRZHits, (int)pSt->nRZMisses, (double)pSt->nBytesUnpacked,
+		(int)pSt->nLiveBlks, (int)pSt->nPoolBlks, (int)CACHE_BLK_SZ8);
+	fclose(pFile);
+}
+
+
 // Nettoyage des sprites trop anciens.
+// Les LRU sont tries par date d'utilisation : On ne regarde que les queues de listes.
 void CacheClearOldSpr(void)
 {
 	u32	i;
-	u32	nNb, nIndex, nTmp;
-
-#if CACHE_DEBUG_INFO == 1
-printf ("CacheClearOldSpr: ");
-#endif
+	s32	nSprNo;
 
-/*
-v1, seulement sur l'age limite.
-*/
-	nNb = gnLRUNb;			// On rcupre les valeurs qui peuvent changer au cours du for.
-	nIndex = gnLRUIndex;
-	for(i = 0; i < nNb; i++)
-	{
-		// Incrmentation de l'age.
-		if (++gpSprUse[gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)]].nAge > CACHE_AGE_MAX)
+	gnCacheFrame++;
+	for (i = 0; i < CACHE_CLASS_NB; i++)
+		while ((nSprNo = gpLRUTail[i]) != -1 && gnCacheFrame - gpSprUse[nSprNo].nFrame > CACHE_AGE_MAX)
 		{
-			// Sprite  supprimer. On swappe l'lment en cours ( supprimer) avec le premier de la liste on supprime le premier lment.
 #if CACHE_DEBUG_INFO == 1
-			printf("(#%d/age %d/pos %d) ", (int)gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)], (int)gpSprUse[gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)]].nAge, (int)gpSprUse[gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)]].nPos);
+printf("CacheClearOldSpr: #%d/%d / pos %d\n", (int)nSprNo>>2, (int)nSprNo&3, (int)gpSprUse[nSprNo].nPos);
 #endif
-
-			nTmp = gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)];
-			gpLRU[(nIndex + i) & (CACHE_BLK_NB - 1)] = gpLRU[gnLRUIndex];
-gpSprUse[gpLRU[gnLRUIndex]].nLRUPos = (nIndex + i) & (CACHE_BLK_NB - 1);	// Nouvel index ancien sprite swapp (valeur dans la case originale encore valide).
-			gpLRU[gnLRUIndex] = nTmp;
-			CacheDeleteFirst();
+			CacheDelete(nSprNo);
+			gCacheStatsCur.nExpired++;
 		}
-	}
 
-#if CACHE_DEBUG_INFO == 1
-printf ("\n");
+#if CACHE_RZ_ON == 1
+	CacheRZ_sub_ClearOld();
 #endif
 
+	Cache_sub_StatsFrameEnd();
+
 }
 
 
+
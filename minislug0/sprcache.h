@@ -1,6 +1,7 @@
 
 
 #define	CACHE_ON	1	// 1 cache / 0 pas de cache.
+#define	CACHE_RZ_ON	1	// 1 cache des roto/zooms / 0 rendu  chaque frame. (Ncessite CACHE_ON  1).
 
 enum
 {
@@ -9,6 +10,31 @@ enum
 };
 
 void CacheClear(void);
-u32 CacheGetMem(u32 nSprNo, u32 nSprSz, u16 **ppGfx);
+void CacheRelease(void);
+u32 CacheGetMem(u32 nSprNo, u32 nSprSz, upix **ppGfx);
 void CacheClearOldSpr(void);
+u32 CacheRZGetMem(u32 nSprNo, void *pFct, u16 nZoomX, u16 nZoomY, u32 nSprSz, upix **ppGfx);
+
+// Stats du cache.
+#define	CACHE_STATS_FILENAME	"cachestats.csv"
+extern	u8	gnCacheStatsCsv;	// 1 = Ajout des stats de chaque niveau dans CACHE_STATS_FILENAME, en fin de niveau (-cachestats).
+
+struct SCacheStats
+{
+	u32	nFrames;		// Nb de frames (stats de niveau).
+	u32	nHits;			// Sprites trouvs dans le cache.
+	u32	nMisses;		// Sprites dpacks.
+	u32	nEvictions;		// Sprites virs pour faire de la place.
+	u32	nExpired;		// Sprites virs car trop vieux (CACHE_AGE_MAX).
+	u32	nFallbacks;		// Cache plein, dpack dans gpSprFlipBuf.
+	u32	nRZHits;		// Roto/zooms trouvs dans le cache.
+	u32	nRZMisses;		// Roto/zooms rendus.
+	uint64_t	nBytesUnpacked;	// Octets dpacks (gfx + masque).
+	u32	nLiveBlks;		// Blocs occups (en fin de frame / max du niveau).
+	u32	nPoolBlks;		// Taille du pool en blocs (en fin de frame / max du niveau).
+};
+
+void CacheStatsGet(struct SCacheStats *pFrame, struct SCacheStats *pLevel);
+void CacheStatsLevelStart(u32 nLevelNo);
+void CacheStatsLevelEnd(void);
 
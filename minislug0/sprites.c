@@ -35,11 +35,11 @@ u8	*gpSprBuf;		// Datas des sprites.
 u32	gnSprBufSz;		// Taille du buffer de data.
 u32	gnSprBufAllocSz;	// Taille du buffer de data alloue pour ne pas faire de rallocs sans arrt.
 
-u16	*gpSprRemapPalettes;	// Palettes de remappage des sprites bout  bout. 1 u16 par couleur au format cran (cd pas RGB), x u16 par pal (voir SPRPAL_SUB_ON et SPR_PAL_SZ).
+upix	*gpSprRemapPalettes;	// Palettes de remappage des sprites bout  bout. 1 upix par couleur au format cran (cd pas RGB), x upix par pal (voir SPRPAL_SUB_ON et SPR_PAL_SZ).
 u32	gnSprRemapPalettesNb;	// Nb de palettes.
 u8	*gpSprPal3Bytes;		// Les couleurs sur 3 bytes.
 
-u16	*gpSprFlipBuf;		// Buffer pour crer les images flippes.
+upix	*gpSprFlipBuf;		// Buffer pour crer les images flippes.
 
 extern u8	*gpRotBuf;	// Buffer pour rendu de la rotation. Sz = ROT2D_BUF_Width * ROT2D_BUF_Height. Pas dans le .H car n'a pas a tre connu d'autre chose que le moteur de sprites.
 
@@ -59,12 +59,63 @@ struct SSprStockage
 	};
 	void	*pFct;			// Ptr sur fct de pr-rendu puis de rendu (mj par fct de pr-rendu) de zoom ou de rotozoom. NULL pour un sprite normal.
 };
-#define	SPR_STO_MAX	512
-struct SSprStockage	gpSprSto[SPR_STO_MAX];
-struct SSprStockage	*gpSprSort[SPR_STO_MAX];	// Pour tri.
+#define	SPRSTO_ALLOC_UNIT	256		// Les listes grandissent par blocs de n sprites.
+#define	SPRSTO_SZ_MAX	16384		// Garde fou.
+struct SSprStockage	*gpSprSto;		// Sprites  afficher dans la frame. Taille conserve d'une frame  l'autre.
+struct SSprStockage	**gpSprSort;	// Pour tri.
+struct SSprStockage	**gpSprSortTmp;	// Pour tri (buffer intermdiaire du radix sort).
 u32	gnSprSto;			// Nb de sprites stocks pour affichage.
+u32	gnSprStoAllocSz;	// Nb de sprites stockables avant le prochain realloc.
+struct SSprStoStats	gSprStoStats;	// Stats des listes d'affichage.
 
 
+// RAZ des stats des listes d'affichage.
+void SprStoStatsReset(void)
+{
+	memset(&gSprStoStats, 0, sizeof(struct SSprStoStats));
+}
+
+// Agrandit les listes d'affichage d'un bloc. La taille est conserve ensuite, pas de malloc  chaque frame.
+// Out : 0 = Ok / 1 = Echec, la liste garde sa taille (sprite perdu).
+u32 SprStoRealloc(void)
+{
+	struct SSprStockage	*pSto;
+	struct SSprStockage	**pSort, **pSortTmp;
+	u32	nNewSz = gnSprStoAllocSz + SPRSTO_ALLOC_UNIT;
+
+	if (nNewSz > SPRSTO_SZ_MAX) goto _err;
+	// Note : gpSprSort ne contient rien de valable pendant l'ajout des sprites, pas besoin de le recaler.
+	if ((pSto = (struct SSprStockage *)realloc(gpSprSto, nNewSz * sizeof(struct SSprStockage))) == NULL) goto _err;
+	gpSprSto = pSto;
+	if ((pSort = (struct SSprStockage **)realloc(gpSprSort, nNewSz * sizeof(struct SSprStockage *))) == NULL) goto _err;
+	gpSprSort = pSort;
+	if ((pSortTmp = (struct SSprStockage **)realloc(gpSprSortTmp, nNewSz * sizeof(struct SSprStockage *))) == NULL) goto _err;
+	gpSprSortTmp = pSortTmp;
+
+	gnSprStoAllocSz = nNewSz;
+	gSprStoStats.nCapacity = nNewSz;
+	gSprStoStats.nGrowNb++;
+#ifdef DEBUG_INFO
+printf("SprStoRealloc(): New size=%d.\n", (int)gnSprStoAllocSz);
+#endif
+	return (0);
+
+_err:
+	if (gSprStoStats.nDroppedNb++ == 0) fprintf(stderr, "Sprites: Out of slots!\n");	// Message seulement la premire fois.
+	gSprStoStats.nFrameDroppedNb++;
+	return (1);
+}
+
+// Fin de frame : Mj des stats et RAZ de la liste pour le prochain tour.
+void SprSto_sub_FrameEnd(void)
+{
+	gSprStoStats.nFrameUsed = gnSprSto;
+	if (gnSprSto > gSprStoStats.nHighWater) gSprStoStats.nHighWater = gnSprSto;
+	gSprStoStats.nLastFrameDroppedNb = gSprStoStats.nFrameDroppedNb;
+	gSprStoStats.nFrameDroppedNb = 0;
+	gnSprSto = 0;
+}
+
 // Initialisation du moteur (1 fois !).
 void SprInitEngine(void)
 {
@@ -79,6 +130,12 @@ void SprInitEngine(void)
 	gnSprBufAllocSz = 0;		// Taille du buffer de data alloue pour ne pas faire de rallocs sans arrt.
 
 	gnSprSto = 0;		// Nb de sprites stocks pour affichage.
+	gpSprSto = NULL;
+	gpSprSort = NULL;
+	gpSprSortTmp = NULL;
+	gnSprStoAllocSz = 0;
+	SprStoStatsReset();
+	SprStoRealloc();	// Premier bloc.
 
 	gpSprRemapPalettes = NULL;	// Palettes de remappage.
 	gnSprRemapPalettesNb = 0;	// Nb de palettes.
@@ -87,6 +144,18 @@ void SprInitEngine(void)
 	gpSprFlipBuf = NULL;	// Buffer pour crer les images flippes.
 	gpRotBuf = NULL;		// Buffer pour rendu de la rotation.
 
+	#if SPRSPAN_ON == 1
+	SprSpanInit();		// Sprites encods en spans.
+	#endif
+
+	#if SPRSIMD_ON == 1
+	SprSimdInit();		// Choix du compositeur.
+	#endif
+
+	#if SPRMT_ON == 1
+	SprMTInit();		// Threads de trac.
+	#endif
+
 	#if CACHE_ON == 1
 	CacheClear();		// RAZ cache.
 	#endif
@@ -277,7 +346,7 @@ printf("Spr biggest sz: lg=%d ht=%d\n", (int)nLgMax, (int)nHtMax);
 		fprintf(stderr, "SprEndCapture(): Zero max with/height found. Aborted.\n");
 		exit(1);
 	}
-	if ((gpSprFlipBuf = (u16 *)malloc(nLgMax * nHtMax * sizeof(u16) * 2)) == NULL)
+	if ((gpSprFlipBuf = (upix *)malloc(nLgMax * nHtMax * sizeof(upix) * 2)) == NULL)
 	{
 		fprintf(stderr, "SprEndCapture(): malloc failed (gpSprFlipBuf).\n");
 		exit(1);
@@ -289,12 +358,16 @@ printf("Spr biggest sz: lg=%d ht=%d\n", (int)nLgMax, (int)nHtMax);
 	}
 
 	// Alloc mmoire palettes de remappage.
-	if ((gpSprRemapPalettes = (u16 *)malloc(gnSprRemapPalettesNb * SPR_PAL_SZ * sizeof(u16))) == NULL)
+	if ((gpSprRemapPalettes = (upix *)malloc(gnSprRemapPalettesNb * SPR_PAL_SZ * sizeof(upix))) == NULL)
 	{
 		printf("SprEndCapture(): malloc failed (gpSprRemapPalettes).\n");
 		exit(1);
 	}
-	SprPaletteConversion();		// Conversion couleurs RGB > u16.
+	SprPaletteConversion();		// Conversion couleurs RGB > format cran.
+
+	#if SPRSPAN_ON == 1
+	SprSpanEncode();			// Encodage des sprites en spans opaques.
+	#endif
 
 #ifdef DEBUG_INFO
 printf("Spr biggest sz (2): lg=%d ht=%d\n", (int)nLgMax, (int)nHtMax);
@@ -313,6 +386,18 @@ void SprRelease(void)
 	free(gpSprPal3Bytes);		// Les couleurs sur 3 bytes.
 	free(gpSprFlipBuf);	// Buffer pour crer les images flippes.
 	free(gpRotBuf);		// Buffer pour gnration des images roto/zoomes.
+	free(gpSprSto);		// Listes d'affichage.
+	free(gpSprSort);
+	free(gpSprSortTmp);
+	#if SPRSPAN_ON == 1
+	SprSpanRelease();	// Sprites encods en spans.
+	#endif
+	#if CACHE_ON == 1
+	CacheRelease();		// Pool du cache.
+	#endif
+	#if SPRMT_ON == 1
+	SprMTRelease();		// Threads de trac.
+	#endif
 
 }
 
@@ -353,7 +438,7 @@ void SprBufRealloc(void)
 #endif
 
 // Renvoie un ptr sur une palette de remappage.
-u16 * SprRemapPalGet(u32 nPalNo)
+upix * SprRemapPalGet(u32 nPalNo)
 {
 	return (gpSprRemapPalettes + (nPalNo * SPR_PAL_SZ));
 }
@@ -391,7 +476,7 @@ u8 * SprPal3BytesAlloc(u32 nNbPalToAdd)
 	return (gpSprPal3Bytes + ((gnSprRemapPalettesNb - nNbPalToAdd) * SPR_PAL_SZ * 3));
 }
 
-// Convertit la palette RGB 3 bytes en couleurs SDL 16 bits.
+// Convertit la palette RGB 3 bytes en couleurs au format de l'cran (16 ou 32 bits, cf. FB32_ON).
 // Conversion spare pour pouvoir au cas ou la refaire quand changement de mode vido.
 void SprPaletteConversion(void)
 {
@@ -951,21 +1036,30 @@ struct SSprite *SprGetDesc(u32 nSprNo)
 
 // Rcupre des pointeurs sur l'image du sprite et son masque.
 // L'image est dpacke (8 bits > 16 bits) et le masque gnr.
-void SprGetGfxMskPtr(u32 nSprFlags, u16 **ppGfx, u16 **ppMsk, struct SSprite *pSprDesc, struct SSprStockage *pSprSto)
+void SprGetGfxMskPtr(u32 nSprFlags, upix **ppGfx, upix **ppMsk, struct SSprite *pSprDesc, struct SSprStockage *pSprSto)
 {
 	s32	i, j, nSz;
-	u16	*pDstG, *pDstM, *pPal;
+	upix	*pDstG, *pDstM, *pPal;
 	u8	*pSrc8;
 
 	nSz = pSprDesc->nLg * pSprDesc->nHt;
 
 	#if CACHE_ON == 1
-	// Cache pas pris en compte pour les rotations/zoom.
 	if (pSprSto->pFct != NULL)
 	{
-		((pRZFctRender)pSprSto->pFct)();	// Appelle le rendu du zoom ou du rotozoom.
+		#if CACHE_RZ_ON == 1
+		// Rotations/zoom, dans leur cache  part.
+		i = CacheRZGetMem(nSprFlags, pSprSto->pFct, pSprSto->nZoomX, pSprSto->nZoomY, nSz, ppGfx);
+		*ppMsk = *ppGfx + nSz;
+		if (i == e_Cache_Hit) return;	// Mme sprite, mme zoom/angle : Pas de rendu.
+		pDstG = *ppGfx;
+		pDstM = *ppMsk;
+		#else
+		// Cache pas pris en compte pour les rotations/zoom.
 		*ppGfx = pDstG = gpSprFlipBuf;
 		*ppMsk = pDstM = gpSprFlipBuf + nSz;
+		#endif
+		((pRZFctRender)pSprSto->pFct)();	// Appelle le rendu du zoom ou du rotozoom.
 	}
 	else
 	{
@@ -999,7 +1093,7 @@ void SprGetGfxMskPtr(u32 nSprFlags, u16 **ppGfx, u16 **ppMsk, struct SSprite *pS
 		for (i = 0; i < nSz; i++)
 		{
 			*pDstG++ = *(pPal + *pSrc8);
-			*pDstM++ = (*(pSrc8++) ? 0 : 0xFFFF);
+			*pDstM++ = (*(pSrc8++) ? 0 : (upix)~0);
 		}
 	}
 	else if ((nSprFlags & (SPR_Flip_X | SPR_Flip_Y)) == (SPR_Flip_X | SPR_Flip_Y))
@@ -1009,7 +1103,7 @@ void SprGetGfxMskPtr(u32 nSprFlags, u16 **ppGfx, u16 **ppMsk, struct SSprite *pS
 		for (i = 0; i < nSz; i++)
 		{
 			*pDstG++ = *(pPal + *pSrc8);
-			*pDstM++ = (*(pSrc8--) ? 0 : 0xFFFF);
+			*pDstM++ = (*(pSrc8--) ? 0 : (upix)~0);
 		}
 	}
 	else if (nSprFlags & SPR_Flip_Y)
@@ -1021,7 +1115,7 @@ void SprGetGfxMskPtr(u32 nSprFlags, u16 **ppGfx, u16 **ppMsk, struct SSprite *pS
 			for (i = 0; i < pSprDesc->nLg; i++)
 			{
 				*pDstG++ = *(pPal + *pSrc8);
-				*pDstM++ = (*(pSrc8++) ? 0 : 0xFFFF);
+				*pDstM++ = (*(pSrc8++) ? 0 : (upix)~0);
 			}
 		}
 	}
@@ -1034,22 +1128,29 @@ void SprGetGfxMskPtr(u32 nSprFlags, u16 **ppGfx, u16 **ppMsk, struct SSprite *pS
 			for (i = 0; i < pSprDesc->nLg; i++)
 			{
 				*pDstG++ = *(pPal + *pSrc8);
-				*pDstM++ = (*(pSrc8--) ? 0 : 0xFFFF);
+				*pDstM++ = (*(pSrc8--) ? 0 : (upix)~0);
 			}
 		}
 	}
 
 }
 
-// Affichage d'un sprite.
-// Avec cran lock.
-void SprDisplayLock(struct SSprStockage *pSprSto)
+// Un sprite prt  tre trac.
+struct SSprDraw
 {
-	s32	nXMin, nXMax, nYMin, nYMax;
+	struct SSprite	sDesc;	// Copie du descripteur (celui des roto/zooms est temporaire).
+	u32	nSprFlags;
+	s32	nXMin, nYMin;		// Position du coin haut gauche  l'cran.
+	upix	*pGfx, *pMsk;		// Gfx et masque dpacks. NULL pour un sprite trac en spans.
+	u32	nArenaOffs;			// (Multithread) Offset du gfx dans l'arne de la frame.
+};
+
+// Prparation du trac d'un sprite : Descripteur, position  l'cran, rcupration du gfx.
+// Out : 0 = Sprite hors cran ou erreur, rien  tracer / 1 = Ok.
+u32 SprDisplay_sub_Setup(struct SSprStockage *pSprSto, struct SSprDraw *pDraw)
+{
+	s32	nXMin, nYMin;
 	s32	nPtRefX, nPtRefY;
-	s32	nSprXMin, nSprXMax, nSprYMin, nSprYMax;
-	s32	diff;
-	u16	*pScr;
 	struct SSprite *pSprDesc;
 
 	u32	nSprFlags = pSprSto->nSprNo;		// Pour conserver les flags.
@@ -1064,7 +1165,7 @@ void SprDisplayLock(struct SSprStockage *pSprSto)
 	{
 		// Sprite roto/zoom, appel de la fonction de pr-rendu qui va bien.
 		pSprDesc = ((pRZFctPreRender)pSprSto->pFct)(nSprFlags, pSprSto->nZoomX, pSprSto->nZoomY, &pSprSto->pFct);
-		if (pSprDesc == NULL) return;	// Il y a eu un pb, abort.
+		if (pSprDesc == NULL) return (0);	// Il y a eu un pb, abort.
 	}
 
 	// Point de ref.
@@ -1078,8 +1179,40 @@ void SprDisplayLock(struct SSprStockage *pSprSto)
 
 	// Prparation du trac.
 	nXMin = pSprSto->nPosX - nPtRefX;
-	nXMax = nXMin + pSprDesc->nLg - 1;
 	nYMin = pSprSto->nPosY - nPtRefY;
+	// Sprite compltement en dehors ? (Les clips sont faits au trac).
+	if (nXMin > SCR_Width - 1 || nXMin + pSprDesc->nLg - 1 < 0) return (0);
+	if (nYMin > SCR_Height - 1 || nYMin + pSprDesc->nHt - 1 < 0) return (0);
+
+	pDraw->sDesc = *pSprDesc;
+	pDraw->nSprFlags = nSprFlags;
+	pDraw->nXMin = nXMin;
+	pDraw->nYMin = nYMin;
+	pDraw->pGfx = pDraw->pMsk = NULL;
+
+	#if SPRSPAN_ON == 1
+	// Sprite standard : Trac direct des spans opaques (pas de dpack, pas de masque).
+	if (pSprSto->pFct == NULL) return (1);
+	#endif
+
+	SprGetGfxMskPtr(nSprFlags, &pDraw->pGfx, &pDraw->pMsk, pSprDesc, pSprSto);
+	return (1);
+}
+
+// Trac d'un sprite prpar, clipp entre les lignes nClipYMin et nClipYMax de l'cran.
+// Avec contexte de rendu ouvert (gRCtx).
+void SprDisplay_sub_Draw(struct SSprDraw *pDraw, s32 nClipYMin, s32 nClipYMax)
+{
+	s32	nXMin, nXMax, nYMin, nYMax;
+	s32	nSprXMin, nSprXMax, nSprYMin, nSprYMax;
+	s32	diff;
+	upix	*pScr;
+	struct SSprite *pSprDesc = &pDraw->sDesc;
+	u32	nSprFlags = pDraw->nSprFlags;
+
+	nXMin = pDraw->nXMin;
+	nXMax = nXMin + pSprDesc->nLg - 1;
+	nYMin = pDraw->nYMin;
 	nYMax = nYMin + pSprDesc->nHt - 1;
 
 	nSprXMin = 0;
@@ -1102,14 +1235,14 @@ void SprDisplayLock(struct SSprStockage *pSprSto)
 //	if (nSprXMin - nSprXMax >= 0) return;	//< bug
 	if (nSprXMin - nSprXMax > 0) return;
 	//
-	if (nYMin < 0)	//aaa0
+	if (nYMin < nClipYMin)	//aaa0
 	{
-		diff = 0 - nYMin;	//aaa0
+		diff = nClipYMin - nYMin;	//aaa0
 		nSprYMin += diff;
 	}
-	if (nYMax > SCR_Height - 1)
+	if (nYMax > nClipYMax)
 	{
-		diff = nYMax - (SCR_Height - 1);
+		diff = nYMax - nClipYMax;
 		nSprYMax -= diff;
 	}
 	// Sprite compltement en dehors ?
@@ -1119,23 +1252,52 @@ void SprDisplayLock(struct SSprStockage *pSprSto)
 
 	s32	ix, iy;
 	u32	b4, /*b1,*/ b4b, b1b;
-	u16	*pGfx, *pMsk;
+	upix	*pGfx, *pMsk;
 //	u32	nScrLg = gVar.pScreen->pitch / sizeof(u16);
-	s32	nScrLg = gVar.pScreen->pitch / sizeof(u16);	// Bugfix 11/10/2012. u32 > s32, car unsigned * signed = unsigned. Et il faut le sign extend en 64 bits !
+	s32	nScrLg = gRCtx.nScrPitch;	// Bugfix 11/10/2012. u32 > s32, car unsigned * signed = unsigned. Et il faut le sign extend en 64 bits !
+
+	#if SPRSPAN_ON == 1
+	if (pDraw->pGfx == NULL)
+	{
+		pScr = gRCtx.pScr;
+		pScr += ((nYMin + nSprYMin) * nScrLg) + nXMin;
+		SprSpanDraw(nSprFlags, pSprDesc, pScr, nScrLg, nSprXMin, nSprXMax, nSprYMin, nSprYMax,
+			(nSprFlags & SPR_Flag_HitPal ? gVar.pScreen->format->Rmask | ((gVar.pScreen->format->Gmask >> 2) & gVar.pScreen->format->Gmask) : 0));	// Mme rouge que "rouge 2" plus bas.
+		return;
+	}
+	#endif
 
-	SprGetGfxMskPtr(nSprFlags, &pGfx, &pMsk, pSprDesc, pSprSto);
+	pGfx = pDraw->pGfx;
+	pMsk = pDraw->pMsk;
 
 	b1b = nSprXMax - nSprXMin + 1;
 //8	b4b = b1b >> 2;		// Nb de quads.
 //8	b1b &= 3;			// Nb d'octets restants ensuite.
 	b4b = b1b >> 1;		// Nb de quads.
 	b1b &= 1;			// Nb de words restants ensuite.
-	pScr = (u16 *)gVar.pScreen->pixels;
+	pScr = gRCtx.pScr;
 //l	pScr += ((nYMin + nSprYMin) * SCR_Width) + nXMin;
 	pScr += ((nYMin + nSprYMin) * nScrLg) + nXMin;
 	pMsk += (nSprYMin * pSprDesc->nLg);
 	pGfx += (nSprYMin * pSprDesc->nLg);
 
+	#if SPRSIMD_ON == 1 || FB32_ON == 1
+	// Compositeur vectoris (mme rsultat que le code C plus bas, "rouge 2" compris). Seul compositeur en 32 bits.
+	b4 = (nSprFlags & SPR_Flag_HitPal ? gVar.pScreen->format->Rmask | ((gVar.pScreen->format->Gmask >> 2) & gVar.pScreen->format->Gmask) : 0);
+	b1b = nSprXMax - nSprXMin + 1;
+	pScr += nSprXMin;
+	pMsk += nSprXMin;
+	pGfx += nSprXMin;
+	for (iy = nSprYMin; iy <= nSprYMax; iy++)
+	{
+		gpSprBlitLn(pScr, pGfx, pMsk, b1b, b4);
+		pScr += nScrLg;
+		pMsk += pSprDesc->nLg;
+		pGfx += pSprDesc->nLg;
+	}
+	return;
+	#endif
+
 	if (nSprFlags & SPR_Flag_HitPal)
 	{
 		// Affichage sprite rougi pour le Hit.
@@ -1228,10 +1390,208 @@ tst3 |= tst3 * 65536;
 }
 
 
+// Affichage d'un sprite.
+// Avec contexte de rendu ouvert (gRCtx).
+void SprDisplayLock(struct SSprStockage *pSprSto)
+{
+	struct SSprDraw	sDraw;
+
+	if (SprDisplay_sub_Setup(pSprSto, &sDraw))
+		SprDisplay_sub_Draw(&sDraw, 0, SCR_Height - 1);
+}
+
+#if SPRMT_ON == 1
+// Trac multithread : L'cran est dcoup en bandes horizontales, chaque thread trace toute la liste trie, clippe sur sa bande.
+// L'ordre des priorits est donc respect dans chaque bande.
+// La prparation (pr-rendus des roto/zooms, accs au cache) reste dans le thread principal. Les gfx dpacks sont recopis
+// dans une arne propre  la frame : Les threads ne font que lire, le cache et gpSprFlipBuf ne sont pas partags.
+#define	SPRMT_BANDS_MAX	8
+#define	SPRMT_MIN_SPR	16		// En dessous de x sprites, trac direct dans le thread principal.
+
+struct SSprMTBand
+{
+	SDL_Thread	*pThread;
+	SDL_sem	*pSemStart;
+	s32	nYMin, nYMax;		// Lignes de la bande.
+};
+struct SSprMTBand	gpSprMTBands[SPRMT_BANDS_MAX];
+u32	gnSprMTBandsNb;			// Nb de bandes (thread principal compris). 1 = pas de multithread.
+SDL_sem	*gpSprMTSemDone;	// Fin de trac des threads.
+volatile u8	gnSprMTQuit;
+
+struct SSprDraw	*gpSprMTDraw;	// Sprites prpars de la frame.
+u32	gnSprMTDrawNb, gnSprMTDrawAllocSz;
+upix	*gpSprMTArena;			// Gfx + masques dpacks de la frame.
+u32	gnSprMTArenaSz, gnSprMTArenaAllocSz;	// En pixels.
+
+// Trac de tous les sprites prpars dans une bande.
+void SprMT_sub_DrawBand(u32 nBand)
+{
+	u32	i;
+
+	for (i = 0; i < gnSprMTDrawNb; i++)
+		SprDisplay_sub_Draw(&gpSprMTDraw[i], gpSprMTBands[nBand].nYMin, gpSprMTBands[nBand].nYMax);
+}
+
+// Boucle des threads de trac.
+int SprMT_sub_Worker(void *pData)
+{
+	u32	nBand = (u32)(intptr_t)pData;
+
+	while (1)
+	{
+		SDL_SemWait(gpSprMTBands[nBand].pSemStart);
+		if (gnSprMTQuit) break;
+		SprMT_sub_DrawBand(nBand);
+		SDL_SemPost(gpSprMTSemDone);
+	}
+	return (0);
+}
+
+// Init du trac multithread (1 fois !).
+void SprMTInit(void)
+{
+	u32	i;
+
+	gpSprMTDraw = NULL;
+	gnSprMTDrawAllocSz = 0;
+	gpSprMTArena = NULL;
+	gnSprMTArenaAllocSz = 0;
+	gnSprMTQuit = 0;
+
+	gnSprMTBandsNb = SDL_GetCPUCount();
+	if (gnSprMTBandsNb > SPRMT_BANDS_MAX) gnSprMTBandsNb = SPRMT_BANDS_MAX;
+	if (gnSprMTBandsNb < 2 || (gpSprMTSemDone = SDL_CreateSemaphore(0)) == NULL)
+	{
+		gnSprMTBandsNb = 1;
+		return;
+	}
+	for (i = 0; i < gnSprMTBandsNb; i++)
+	{
+		gpSprMTBands[i].nYMin = (i * SCR_Height) / gnSprMTBandsNb;
+		gpSprMTBands[i].nYMax = (((i + 1) * SCR_Height) / gnSprMTBandsNb) - 1;
+		gpSprMTBands[i].pThread = NULL;
+		gpSprMTBands[i].pSemStart = NULL;
+		if (i == 0) continue;		// Bande 0 : Thread principal.
+		if ((gpSprMTBands[i].pSemStart = SDL_CreateSemaphore(0)) == NULL ||
+			(gpSprMTBands[i].pThread = SDL_CreateThread(SprMT_sub_Worker, "SprBand", (void *)(intptr_t)i)) == NULL)
+		{
+			fprintf(stderr, "SprMTInit(): Thread creation failed, single thread rendering.\n");
+			SprMTRelease();
+			return;
+		}
+	}
+#ifdef DEBUG_INFO
+printf("SprMTInit: %d bands.\n", (int)gnSprMTBandsNb);
+#endif
+}
+
+// Arrt des threads et nettoyage (1 fois !).
+void SprMTRelease(void)
+{
+	u32	i;
+
+	gnSprMTQuit = 1;
+	for (i = 1; i < gnSprMTBandsNb; i++)
+	{
+		if (gpSprMTBands[i].pThread != NULL)
+		{
+			SDL_SemPost(gpSprMTBands[i].pSemStart);
+			SDL_WaitThread(gpSprMTBands[i].pThread, NULL);
+		}
+		if (gpSprMTBands[i].pSemStart != NULL) SDL_DestroySemaphore(gpSprMTBands[i].pSemStart);
+	}
+	if (gnSprMTBandsNb > 1) SDL_DestroySemaphore(gpSprMTSemDone);
+	gnSprMTBandsNb = 1;
+	free(gpSprMTDraw);
+	free(gpSprMTArena);
+	gpSprMTDraw = NULL;
+	gpSprMTArena = NULL;
+	gnSprMTDrawAllocSz = gnSprMTArenaAllocSz = 0;
+}
+
+// Affichage multithread d'une partie de la liste trie.
+void SprMT_sub_DisplayList(u32 nFirst, u32 nLast)
+{
+	u32	i, nSz;
+	struct SSprDraw	*pDraw;
+
+	// Prparation, dans l'ordre de la liste.
+	if (nLast - nFirst > gnSprMTDrawAllocSz)
+	{
+		if ((pDraw = (struct SSprDraw *)realloc(gpSprMTDraw, (nLast - nFirst) * sizeof(struct SSprDraw))) == NULL)
+		{
+			fprintf(stderr, "SprMT_sub_DisplayList(): realloc failed.\n");
+			exit(1);
+		}
+		gpSprMTDraw = pDraw;
+		gnSprMTDrawAllocSz = nLast - nFirst;
+	}
+	gnSprMTDrawNb = 0;
+	gnSprMTArenaSz = 0;
+	for (i = nFirst; i < nLast; i++)
+	{
+		pDraw = &gpSprMTDraw[gnSprMTDrawNb];
+		if (SprDisplay_sub_Setup(gpSprSort[i], pDraw) == 0) continue;
+		if (pDraw->pGfx != NULL)
+		{
+			// Sprite dpack : Copie gfx + masque dans l'arne. (Les ptrs du cache ne sont valables que jusqu'au prochain accs).
+			nSz = pDraw->sDesc.nLg * pDraw->sDesc.nHt * 2;
+			if (gnSprMTArenaSz + nSz > gnSprMTArenaAllocSz)
+			{
+				upix	*pArena;
+				if ((pArena = (upix *)realloc(gpSprMTArena, (gnSprMTArenaSz + nSz) * 2 * sizeof(upix))) == NULL)
+				{
+					fprintf(stderr, "SprMT_sub_DisplayList(): realloc failed (arena).\n");
+					exit(1);
+				}
+				gpSprMTArena = pArena;
+				gnSprMTArenaAllocSz = (gnSprMTArenaSz + nSz) * 2;
+			}
+			memcpy(gpSprMTArena + gnSprMTArenaSz, pDraw->pGfx, nSz * sizeof(upix));	// (Le masque suit le gfx).
+			pDraw->nArenaOffs = gnSprMTArenaSz;
+			gnSprMTArenaSz += nSz;
+		}
+		gnSprMTDrawNb++;
+	}
+	// Pointeurs dans l'arne (elle ne bouge plus).
+	for (i = 0; i < gnSprMTDrawNb; i++)
+	{
+		pDraw = &gpSprMTDraw[i];
+		if (pDraw->pGfx == NULL) continue;
+		pDraw->pGfx = gpSprMTArena + pDraw->nArenaOffs;
+		pDraw->pMsk = pDraw->pGfx + (pDraw->sDesc.nLg * pDraw->sDesc.nHt);
+	}
+
+	// Trac : Les threads prennent chacun leur bande, le thread principal fait la bande 0.
+	for (i = 1; i < gnSprMTBandsNb; i++) SDL_SemPost(gpSprMTBands[i].pSemStart);
+	SprMT_sub_DrawBand(0);
+	for (i = 1; i < gnSprMTBandsNb; i++) SDL_SemWait(gpSprMTSemDone);
+}
+#endif
+
+// Affichage des sprites gpSprSort[nFirst]  gpSprSort[nLast - 1].
+// Avec contexte de rendu ouvert (gRCtx).
+void SprDisplay_sub_List(u32 nFirst, u32 nLast)
+{
+	u32	i;
+
+	#if SPRMT_ON == 1
+	if (gnSprMTBandsNb > 1 && nLast - nFirst >= SPRMT_MIN_SPR)
+	{
+		SprMT_sub_DisplayList(nFirst, nLast);
+		return;
+	}
+	#endif
+	for (i = nFirst; i < nLast; i++)
+		SprDisplayLock(gpSprSort[i]);
+}
+
+
 // Macros pour viter des calls :
 #define	SPR_ADD_TO_LIST(POSX, POSY, PRIO, FPTR) \
-	if (gnSprSto >= SPR_STO_MAX) { fprintf(stderr, "Sprites: Out of slots!\n"); return; } \
 	if ((nSprNo & ~(SPR_Flip_X | SPR_Flip_Y)) == SPR_NoSprite) return; \
+	if (gnSprSto >= gnSprStoAllocSz && SprStoRealloc()) return; \
 	gpSprSto[gnSprSto].nSprNo = nSprNo; \
 	gpSprSto[gnSprSto].nPosX = POSX; \
 	gpSprSto[gnSprSto].nPosY = POSY; \
@@ -1241,7 +1601,6 @@ tst3 |= tst3 * 65536;
 	gpSprSto[gnSprSto].nZoomX = ZOOMX; \
 	gpSprSto[gnSprSto].nZoomY = ZOOMY;
 #define	SPR_ADD_TO_LIST_END \
-	gpSprSort[gnSprSto] = &gpSprSto[gnSprSto]; \
 	gnSprSto++;
 
 // Inscrit les sprites dans une liste, position relative par rapport  la map.
@@ -1326,24 +1685,47 @@ void SprDisplayRotoZoomAbsolute(u32 nSprNo, s32 nPosX, s32 nPosY, u16 nPrio, u8
 
 
 
-// La comparaison du qsort.
-int qscmp(const void *pEl1, const void *pEl2)
+// Tri de gpSprSort sur nPrio.
+// Radix sort en 2 passes de 8 bits (poids faible puis poids fort). Stable : A priorit gale, les sprites restent dans l'ordre d'ajout (pas de scintillement).
+void SprSort(void)
 {
-	return ((*(struct SSprStockage **)pEl1)->nPrio - (*(struct SSprStockage **)pEl2)->nPrio);
-}
+	u32	pHistoLo[256], pHistoHi[256];
+	u32	i, nSum, nTmp;
+
+	memset(pHistoLo, 0, sizeof(pHistoLo));
+	memset(pHistoHi, 0, sizeof(pHistoHi));
+	for (i = 0; i < gnSprSto; i++)
+	{
+		pHistoLo[gpSprSto[i].nPrio & 0xFF]++;
+		pHistoHi[gpSprSto[i].nPrio >> 8]++;
+	}
+
+	// Passe 1 : Poids faible, de gpSprSto (ordre d'ajout) vers gpSprSortTmp.
+	for (nSum = 0, i = 0; i < 256; i++) { nTmp = pHistoLo[i]; pHistoLo[i] = nSum; nSum += nTmp; }
+	for (i = 0; i < gnSprSto; i++)
+		gpSprSortTmp[pHistoLo[gpSprSto[i].nPrio & 0xFF]++] = &gpSprSto[i];
+
+	// Passe 2 : Poids fort, de gpSprSortTmp vers gpSprSort.
+	if (pHistoHi[gpSprSto[0].nPrio >> 8] == gnSprSto)
+	{
+		// Tous les sprites ont le mme poids fort (cas courant), la passe 1 suffit.
+		memcpy(gpSprSort, gpSprSortTmp, gnSprSto * sizeof(struct SSprStockage *));
+		return;
+	}
+	for (nSum = 0, i = 0; i < 256; i++) { nTmp = pHistoHi[i]; pHistoHi[i] = nSum; nSum += nTmp; }
+	for (i = 0; i < gnSprSto; i++)
+		gpSprSort[pHistoHi[gpSprSortTmp[i]->nPrio >> 8]++] = gpSprSortTmp[i];
 
-extern	u8	gnFrameMissed;
+}
 
 // Trie la liste des sprites et les affiche.
 // A appeler une fois par frame.
 void SprDisplayAll(void)
 {
-	u32	i;
-
 //	if (gnSprSto == 0)	// Rien  faire ?
 	if (gnSprSto == 0 || gnFrameMissed)	// Rien  faire ?
 	{
-		gnSprSto = 0;			// RAZ pour le prochain tour (frame miss).
+		SprSto_sub_FrameEnd();	// RAZ pour le prochain tour (frame miss).
 		#if CACHE_ON == 1
 		CacheClearOldSpr();		// Nettoyage des sprites trop vieux du cache.
 		#endif
@@ -1351,17 +1733,15 @@ void SprDisplayAll(void)
 	}
 
 	// Tri sur la priorit.
-	qsort(gpSprSort, gnSprSto, sizeof(struct SSprStockage *), qscmp);
+	SprSort();
 
 	// Affichage.
-	SDL_LockSurface(gVar.pScreen);
+	RCtx_FrameBegin();	// Contexte de rendu (lock unique de la frame).
 	// Sprites normaux.
-	for (i = 0; i < gnSprSto; i++)
-		SprDisplayLock(gpSprSort[i]);
-	SDL_UnlockSurface(gVar.pScreen);
+	SprDisplay_sub_List(0, gnSprSto);
 
 	// RAZ pour le prochain tour.
-	gnSprSto = 0;
+	SprSto_sub_FrameEnd();
 
 	#if CACHE_ON == 1
 	CacheClearOldSpr();		// Nettoyage des sprites trop vieux du cache.
@@ -1381,19 +1761,18 @@ void SprDisplayAll_Pass1(void)
 //	if (gnSprSto == 0)	// Rien  faire ?
 	if (gnSprSto == 0 || gnFrameMissed)	// Rien  faire ?
 	{
-		gnSprSto = 0;			// RAZ pour le prochain tour (frame miss).
+		SprSto_sub_FrameEnd();	// RAZ pour le prochain tour (frame miss).
 		gnSprPass2Last = 0;		// Pour Pass2.
 		return;
 	}
 
 	// Tri sur la priorit.
-	qsort(gpSprSort, gnSprSto, sizeof(struct SSprStockage *), qscmp);
+	SprSort();
 
 	// Affichage.
-	SDL_LockSurface(gVar.pScreen);
-	for (i = 0; i < gnSprSto && gpSprSort[i]->nPrio < 0x100; i++)
-		SprDisplayLock(gpSprSort[i]);
-	SDL_UnlockSurface(gVar.pScreen);
+	RCtx_FrameBegin();
+	for (i = 0; i < gnSprSto && gpSprSort[i]->nPrio < 0x100; i++);
+	SprDisplay_sub_List(0, i);
 
 	// Il en reste ? => Prio > 0x100. On note les valeurs en cours.
 	if (i < gnSprSto)
@@ -1405,7 +1784,7 @@ void SprDisplayAll_Pass1(void)
 		gnSprPass2Last = 0;
 
 	// RAZ pour le prochain tour.
-	gnSprSto = 0;
+	SprSto_sub_FrameEnd();
 
 }
 
@@ -1413,16 +1792,12 @@ void SprDisplayAll_Pass1(void)
 // A appeler une fois par frame, APRES SprDisplayAll_Pass1 !
 void SprDisplayAll_Pass2(void)
 {
-	u32	i;
-
 	if (gnFrameMissed == 0)
 	if (gnSprPass2Last)		// Quelque chose  faire ?
 	{
 		// Affichage.
-		SDL_LockSurface(gVar.pScreen);
-		for (i = gnSprPass2Idx; i < gnSprPass2Last; i++)
-			SprDisplayLock(gpSprSort[i]);
-		SDL_UnlockSurface(gVar.pScreen);
+		RCtx_FrameBegin();
+		SprDisplay_sub_List(gnSprPass2Idx, gnSprPass2Last);
 	}
 
 	#if CACHE_ON == 1
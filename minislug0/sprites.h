@@ -1,5 +1,11 @@
 
 
+#ifdef __EMSCRIPTEN__
+#define	SPRMT_ON	0	// Pas de threads en WASM.
+#else
+#define	SPRMT_ON	1	// 1 = trac des sprites multithread (bandes horizontales) / 0 = un seul thread.
+#endif
+
 #define	SPR_Flip_X		(1 << 31)
 #define	SPR_Flip_Y		(1 << 30)
 #define	SPR_Flag_HitPal		(1 << 29)
@@ -50,6 +56,19 @@ struct SSprite
 };
 #pragma pack()
 
+// Stats des listes d'affichage.
+struct SSprStoStats
+{
+	u32	nCapacity;			// Nb de sprites stockables actuellement.
+	u32	nHighWater;			// Nb max de sprites dans une frame (depuis la dernire RAZ).
+	u32	nFrameUsed;			// Nb de sprites dans la dernire frame.
+	u32	nGrowNb;			// Nb d'agrandissements des listes.
+	u32	nDroppedNb;			// Nb total de sprites perdus (liste pleine et realloc impossible).
+	u32	nFrameDroppedNb;	// Nb de sprites perdus dans la frame en cours.
+	u32	nLastFrameDroppedNb;	// Nb de sprites perdus dans la dernire frame.
+};
+extern struct SSprStoStats	gSprStoStats;
+
 
 // Prototypes.
 void SprInitEngine(void);
@@ -72,6 +91,10 @@ void SprDisplayRotoZoomAbsolute(u32 nSprNo, s32 nPosX, s32 nPosY, u16 nPrio, u8
 void SprDisplayAll(void);
 void SprDisplayAll_Pass1(void);
 void SprDisplayAll_Pass2(void);
+u32 SprStoRealloc(void);
+void SprMTInit(void);
+void SprMTRelease(void);
+void SprStoStatsReset(void);
 
 struct SSprite *SprGetDesc(u32 nSprNo);
 u32 SprCheckColBox(u32 nSpr1, s32 nPosX1, s32 nPosY1, u32 nSpr2, s32 nPosX2, s32 nPosY2);
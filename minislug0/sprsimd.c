@@ -0,0 +1,229 @@
+// Compositeur des sprites dpacks (gfx au format cran + masque), vectoris.
+// Une seule routine pour l'affichage normal et pour le hit (nHitClr = 0 en normal) :
+// Scr = (Scr & Msk) | Gfx | (~Msk & nHitClr).
+// Plus la copie des plans de scroll avec couleur transparente, mme principe avec un masque calcul par comparaison.
+// Le choix de la routine est fait une fois  l'init, suivant ce qui a t compil et ce que le CPU sait faire.
+
+#include "includes.h"
+
+#if SPRSIMD_ON == 1
+	#if defined(__wasm_simd128__)
+		#include <wasm_simd128.h>
+		#define	SPRSIMD_WASM	1
+	#elif defined(__SSE2__) || defined(_M_X64)
+		#include <emmintrin.h>
+		#define	SPRSIMD_SSE2	1
+		#if defined(__GNUC__) || defined(__clang__)
+			#include <immintrin.h>
+			#define	SPRSIMD_AVX2	1
+		#endif
+	#endif
+#endif
+
+pSprBlitLn	gpSprBlitLn;
+pKeyBlitLn	gpKeyBlitLn;
+
+#if FB32_ON == 1
+// Version C (fallback), 1 pixel par tour.
+void SprBlitLn_C(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr)
+{
+	for (; nPix; nPix--, pScr++, pGfx++, pMsk++)
+		*pScr = (*pScr & *pMsk) | *pGfx | (~*pMsk & nHitClr);
+}
+#else
+// Version C (fallback), 2 pixels par tour.
+void SprBlitLn_C(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr)
+{
+	u32	b4;
+
+	nHitClr |= nHitClr << 16;
+	for (b4 = nPix >> 1; b4; b4--, pScr += 2, pGfx += 2, pMsk += 2)
+		*(u32 *)pScr = (*(u32 *)pScr & *(u32 *)pMsk) | *(u32 *)pGfx | (~*(u32 *)pMsk & nHitClr);
+	if (nPix & 1)	// Un dernier pixel ?
+		*pScr = (*pScr & *pMsk) | *pGfx | (~*pMsk & nHitClr);
+}
+#endif
+
+// Nb de pixels par registre SIMD de 128 bits.
+#define	SPRSIMD_PIX128	(16 / sizeof(upix))
+
+#ifdef SPRSIMD_SSE2
+// SSE2, 128 bits par tour.
+void SprBlitLn_SSE2(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr)
+{
+#if FB32_ON == 1
+	__m128i	vHit = _mm_set1_epi32((int)nHitClr);
+#else
+	__m128i	vHit = _mm_set1_epi16((short)nHitClr);
+#endif
+	__m128i	vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128; nPix -= SPRSIMD_PIX128, pScr += SPRSIMD_PIX128, pGfx += SPRSIMD_PIX128, pMsk += SPRSIMD_PIX128)
+	{
+		vMsk = _mm_loadu_si128((__m128i *)pMsk);
+		_mm_storeu_si128((__m128i *)pScr,
+			_mm_or_si128(_mm_and_si128(_mm_loadu_si128((__m128i *)pScr), vMsk),
+				_mm_or_si128(_mm_loadu_si128((__m128i *)pGfx), _mm_andnot_si128(vMsk, vHit))));
+	}
+	if (nPix) SprBlitLn_C(pScr, pGfx, pMsk, nPix, nHitClr);	// Reste.
+}
+#endif
+
+#ifdef SPRSIMD_AVX2
+// AVX2, 256 bits par tour. Compile pour l'AVX2 mme si le reste ne l'est pas, appele seulement si le CPU le supporte.
+__attribute__((target("avx2")))
+void SprBlitLn_AVX2(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr)
+{
+#if FB32_ON == 1
+	__m256i	vHit = _mm256_set1_epi32((int)nHitClr);
+#else
+	__m256i	vHit = _mm256_set1_epi16((short)nHitClr);
+#endif
+	__m256i	vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128 * 2; nPix -= SPRSIMD_PIX128 * 2, pScr += SPRSIMD_PIX128 * 2, pGfx += SPRSIMD_PIX128 * 2, pMsk += SPRSIMD_PIX128 * 2)
+	{
+		vMsk = _mm256_loadu_si256((__m256i *)pMsk);
+		_mm256_storeu_si256((__m256i *)pScr,
+			_mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256((__m256i *)pScr), vMsk),
+				_mm256_or_si256(_mm256_loadu_si256((__m256i *)pGfx), _mm256_andnot_si256(vMsk, vHit))));
+	}
+	if (nPix) SprBlitLn_SSE2(pScr, pGfx, pMsk, nPix, nHitClr);	// Reste.
+}
+#endif
+
+#ifdef SPRSIMD_WASM
+// WebAssembly simd128, 128 bits par tour.
+void SprBlitLn_Wasm(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr)
+{
+#if FB32_ON == 1
+	v128_t	vHit = wasm_i32x4_splat((s32)nHitClr);
+#else
+	v128_t	vHit = wasm_i16x8_splat((s16)nHitClr);
+#endif
+	v128_t	vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128; nPix -= SPRSIMD_PIX128, pScr += SPRSIMD_PIX128, pGfx += SPRSIMD_PIX128, pMsk += SPRSIMD_PIX128)
+	{
+		vMsk = wasm_v128_load(pMsk);
+		wasm_v128_store(pScr,
+			wasm_v128_or(wasm_v128_and(wasm_v128_load(pScr), vMsk),
+				wasm_v128_or(wasm_v128_load(pGfx), wasm_v128_andnot(vHit, vMsk))));
+	}
+	if (nPix) SprBlitLn_C(pScr, pGfx, pMsk, nPix, nHitClr);	// Reste.
+}
+#endif
+
+//=============================================================================
+
+// Version C (fallback).
+void KeyBlitLn_C(upix *pScr, upix *pSrc, u32 nPix, u32 nKey)
+{
+	for (; nPix; nPix--, pScr++, pSrc++)
+		if (*pSrc != (upix)nKey) *pScr = *pSrc;
+}
+
+#ifdef SPRSIMD_SSE2
+// SSE2, 128 bits par tour.
+void KeyBlitLn_SSE2(upix *pScr, upix *pSrc, u32 nPix, u32 nKey)
+{
+#if FB32_ON == 1
+	__m128i	vKey = _mm_set1_epi32((int)nKey);
+#else
+	__m128i	vKey = _mm_set1_epi16((short)nKey);
+#endif
+	__m128i	vSrc, vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128; nPix -= SPRSIMD_PIX128, pScr += SPRSIMD_PIX128, pSrc += SPRSIMD_PIX128)
+	{
+		vSrc = _mm_loadu_si128((__m128i *)pSrc);
+#if FB32_ON == 1
+		vMsk = _mm_cmpeq_epi32(vSrc, vKey);
+#else
+		vMsk = _mm_cmpeq_epi16(vSrc, vKey);
+#endif
+		_mm_storeu_si128((__m128i *)pScr,
+			_mm_or_si128(_mm_and_si128(_mm_loadu_si128((__m128i *)pScr), vMsk), _mm_andnot_si128(vMsk, vSrc)));
+	}
+	if (nPix) KeyBlitLn_C(pScr, pSrc, nPix, nKey);	// Reste.
+}
+#endif
+
+#ifdef SPRSIMD_AVX2
+// AVX2, 256 bits par tour.
+__attribute__((target("avx2")))
+void KeyBlitLn_AVX2(upix *pScr, upix *pSrc, u32 nPix, u32 nKey)
+{
+#if FB32_ON == 1
+	__m256i	vKey = _mm256_set1_epi32((int)nKey);
+#else
+	__m256i	vKey = _mm256_set1_epi16((short)nKey);
+#endif
+	__m256i	vSrc, vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128 * 2; nPix -= SPRSIMD_PIX128 * 2, pScr += SPRSIMD_PIX128 * 2, pSrc += SPRSIMD_PIX128 * 2)
+	{
+		vSrc = _mm256_loadu_si256((__m256i *)pSrc);
+#if FB32_ON == 1
+		vMsk = _mm256_cmpeq_epi32(vSrc, vKey);
+#else
+		vMsk = _mm256_cmpeq_epi16(vSrc, vKey);
+#endif
+		_mm256_storeu_si256((__m256i *)pScr,
+			_mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256((__m256i *)pScr), vMsk), _mm256_andnot_si256(vMsk, vSrc)));
+	}
+	if (nPix) KeyBlitLn_SSE2(pScr, pSrc, nPix, nKey);	// Reste.
+}
+#endif
+
+#ifdef SPRSIMD_WASM
+// WebAssembly simd128, 128 bits par tour.
+void KeyBlitLn_Wasm(upix *pScr, upix *pSrc, u32 nPix, u32 nKey)
+{
+#if FB32_ON == 1
+	v128_t	vKey = wasm_i32x4_splat((s32)nKey);
+#else
+	v128_t	vKey = wasm_i16x8_splat((s16)nKey);
+#endif
+	v128_t	vSrc, vMsk;
+
+	for (; nPix >= SPRSIMD_PIX128; nPix -= SPRSIMD_PIX128, pScr += SPRSIMD_PIX128, pSrc += SPRSIMD_PIX128)
+	{
+		vSrc = wasm_v128_load(pSrc);
+#if FB32_ON == 1
+		vMsk = wasm_i32x4_eq(vSrc, vKey);
+#else
+		vMsk = wasm_i16x8_eq(vSrc, vKey);
+#endif
+		wasm_v128_store(pScr, wasm_v128_bitselect(wasm_v128_load(pScr), vSrc, vMsk));
+	}
+	if (nPix) KeyBlitLn_C(pScr, pSrc, nPix, nKey);	// Reste.
+}
+#endif
+
+// Choix de la routine (1 fois !).
+void SprSimdInit(void)
+{
+	gpSprBlitLn = SprBlitLn_C;
+	gpKeyBlitLn = KeyBlitLn_C;
+#if defined(SPRSIMD_WASM)
+	gpSprBlitLn = SprBlitLn_Wasm;
+	gpKeyBlitLn = KeyBlitLn_Wasm;
+#elif defined(SPRSIMD_SSE2)
+	gpSprBlitLn = SprBlitLn_SSE2;
+	gpKeyBlitLn = KeyBlitLn_SSE2;
+	#ifdef SPRSIMD_AVX2
+	if (SDL_HasAVX2())
+	{
+		gpSprBlitLn = SprBlitLn_AVX2;
+		gpKeyBlitLn = KeyBlitLn_AVX2;
+	}
+	#endif
+#endif
+
+#ifdef DEBUG_INFO
+printf("SprSimdInit: %s.\n", (gpSprBlitLn == SprBlitLn_C ? "C" : "SIMD"));
+#endif
+
+}
+
@@ -0,0 +1,14 @@
+
+#define	SPRSIMD_ON	1	// 1 = compositeur SIMD si dispo (SSE2/AVX2/simd128) / 0 = code C seul.
+
+// Compose une ligne de sprite dpack : Scr = (Scr & Msk) | Gfx | (~Msk & HitClr).
+typedef void (*pSprBlitLn)(upix *pScr, upix *pGfx, upix *pMsk, u32 nPix, u32 nHitClr);
+extern pSprBlitLn	gpSprBlitLn;
+
+// Copie une ligne avec une couleur transparente (plans de scroll) : Scr = (Src == Key ? Scr : Src).
+typedef void (*pKeyBlitLn)(upix *pScr, upix *pSrc, u32 nPix, u32 nKey);
+extern pKeyBlitLn	gpKeyBlitLn;
+
+// Prototypes.
+void SprSimdInit(void);
+
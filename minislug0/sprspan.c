@@ -0,0 +1,268 @@
+// Les sprites encods en spans (RLE).
+// Chaque ligne d'un sprite est stocke sous forme de spans opaques : on ne stocke et ne trace plus les pixels transparents.
+// Plus besoin de dpacker en 16 bits ni de gnrer de masque.
+//
+// Deux modes, choisis au lancement (SprSpanAtlasSet) :
+// - Index : Les spans contiennent les index de couleurs 8 bits, convertis par la palette au trac. Peu de mmoire (WASM).
+// - Atlas : Les spans contiennent directement les pixels au format cran (16 ou 32 bits), et il y a une version flippe en x. Le trac est une simple copie.
+
+#include "includes.h"
+
+// Format d'un sprite dans gpSprSpanBuf (align sur 4 octets) :
+// u32 pRowOffs[nVar][nHt]	Offset de chaque ligne, depuis le dbut du sprite. nVar = 1 en mode index, 2 en mode atlas (normal / flip x).
+// Puis pour chaque ligne :
+// u16 nSpansNb				Nb de spans opaques dans la ligne.
+// u16 pSpans[nSpansNb][2]	Pour chaque span : position x dans la ligne (skip depuis le bord gauche), longueur.
+// u8 / upix pPix[]			Les pixels de tous les spans de la ligne, bout  bout. Index u8 (+ padding sur 2 octets) ou pixels upix en mode atlas.
+//							En mode atlas, pPix et la ligne suivante sont aligns sur sizeof(upix) (rien  faire en 16 bits).
+
+u8	*gpSprSpanBuf;		// Datas des sprites encods.
+u32	*gpSprSpanOffs;		// Offset de chaque sprite dans gpSprSpanBuf.
+u8	gnSprSpanAtlas = SPRSPAN_ATLAS_DEF;	// Mode atlas (1) ou index (0).
+
+extern struct SSprite	*gpSprDef;
+extern u32	gnSprNbSprites;
+
+upix * SprRemapPalGet(u32 nPalNo);
+
+// Taille de l'entte d'une ligne en mode atlas (nb de spans + spans), aligne pour les pixels.
+#define	SPRSPAN_ATLAS_HDRSZ(nSpansNb)	((sizeof(u16) * (1 + (nSpansNb) * 2) + sizeof(upix) - 1) & ~(sizeof(upix) - 1))
+
+// Init (1 fois !).
+void SprSpanInit(void)
+{
+	gpSprSpanBuf = NULL;
+	gpSprSpanOffs = NULL;
+}
+
+// Nettoyage (1 fois !).
+void SprSpanRelease(void)
+{
+	free(gpSprSpanBuf);
+	free(gpSprSpanOffs);
+	SprSpanInit();
+}
+
+// Choix du mode,  faire avant le chargement des sprites.
+void SprSpanAtlasSet(u32 nAtlas)
+{
+	gnSprSpanAtlas = (nAtlas ? 1 : 0);
+}
+
+// Encode un sprite. Si pDst == NULL, on calcule juste la taille ncessaire.
+// Out : Taille du sprite encod, en octets.
+u32 SprSpan_sub_Encode(struct SSprite *pSprDesc, u8 *pDst)
+{
+	s32	x, nRun;
+	u32	y, nVar, nVarNb;
+	u32	nOffs, nSpansNb, nPixNb;
+	u32	nPixSz = (gnSprSpanAtlas ? sizeof(upix) : sizeof(u8));
+	u32	nAlign = (gnSprSpanAtlas ? sizeof(upix) : sizeof(u16));
+	u8	*pSrc8;
+	u16	*pSpan;
+	upix	*pPal;
+	u8	*pPix;
+	s32	nInc;
+
+	pPal = SprRemapPalGet(pSprDesc->nRemapPalNo);
+	nVarNb = (gnSprSpanAtlas ? 2 : 1);
+	nOffs = nVarNb * pSprDesc->nHt * sizeof(u32);	// Table des offsets des lignes.
+	for (nVar = 0; nVar < nVarNb; nVar++)
+	for (y = 0; y < pSprDesc->nHt; y++)
+	{
+		// Ligne source, lue  l'envers pour la version flippe en x.
+		pSrc8 = pSprDesc->pGfx8 + (y * pSprDesc->nLg);
+		nInc = 1;
+		if (nVar)
+		{
+			pSrc8 += pSprDesc->nLg - 1;
+			nInc = -1;
+		}
+
+		// Comptage des spans et des pixels opaques de la ligne.
+		nSpansNb = 0;
+		nPixNb = 0;
+		for (x = 0; x < pSprDesc->nLg; x++)
+		{
+			if (pSrc8[x * nInc] == 0) continue;
+			if (x == 0 || pSrc8[(x - 1) * nInc] == 0) nSpansNb++;
+			nPixNb++;
+		}
+
+		if (pDst != NULL)
+		{
+			((u32 *)pDst)[(nVar * pSprDesc->nHt) + y] = nOffs;
+			pSpan = (u16 *)(pDst + nOffs);
+			pPix = (gnSprSpanAtlas ? pDst + nOffs + SPRSPAN_ATLAS_HDRSZ(nSpansNb) : (u8 *)(pSpan + 1 + (nSpansNb * 2)));
+			*pSpan++ = nSpansNb;
+			for (x = 0; x < pSprDesc->nLg; )
+			{
+				// Skippe les pixels transparents.
+				if (pSrc8[x * nInc] == 0) { x++; continue; }
+				// Span opaque.
+				for (nRun = 0; x + nRun < pSprDesc->nLg && pSrc8[(x + nRun) * nInc]; nRun++)
+				{
+					if (gnSprSpanAtlas)
+						((upix *)pPix)[nRun] = pPal[pSrc8[(x + nRun) * nInc]];
+					else
+						pPix[nRun] = pSrc8[(x + nRun) * nInc];
+				}
+				pPix += nRun * nPixSz;
+				*pSpan++ = x;
+				*pSpan++ = nRun;
+				x += nRun;
+			}
+		}
+
+		if (gnSprSpanAtlas)
+			nOffs += SPRSPAN_ATLAS_HDRSZ(nSpansNb) + ((nPixNb * nPixSz + nAlign - 1) & ~(nAlign - 1));
+		else
+			nOffs += sizeof(u16) + (nSpansNb * 2 * sizeof(u16)) + ((nPixNb * nPixSz + 1) & ~1);
+	}
+
+	return ((nOffs + 3) & ~3);
+}
+
+// Encodage de tous les sprites (1 fois !). A appeler APRES la mise en place des pointeurs pGfx8 et la conversion des palettes.
+void SprSpanEncode(void)
+{
+	u32	i;
+	u32	nSz;
+
+	if ((gpSprSpanOffs = (u32 *)malloc(gnSprNbSprites * sizeof(u32))) == NULL)
+	{
+		fprintf(stderr, "SprSpanEncode(): malloc failed (gpSprSpanOffs).\n");
+		exit(1);
+	}
+	// Passe 1 : Calcul des tailles.
+	nSz = 0;
+	for (i = 0; i < gnSprNbSprites; i++)
+	{
+		gpSprSpanOffs[i] = nSz;
+		nSz += SprSpan_sub_Encode(&gpSprDef[i], NULL);
+	}
+	if ((gpSprSpanBuf = (u8 *)malloc(nSz)) == NULL)
+	{
+		fprintf(stderr, "SprSpanEncode(): malloc failed (gpSprSpanBuf).\n");
+		exit(1);
+	}
+	// Passe 2 : Encodage.
+	for (i = 0; i < gnSprNbSprites; i++)
+		SprSpan_sub_Encode(&gpSprDef[i], gpSprSpanBuf + gpSprSpanOffs[i]);
+
+#ifdef DEBUG_INFO
+printf("SprSpanEncode: %d sprites, %d bytes (%s).\n", (int)gnSprNbSprites, (int)nSz, (gnSprSpanAtlas ? "atlas" : "index"));
+#endif
+
+}
+
+// Affichage d'un sprite encod, mode atlas.
+// Les flips x sont pr-calculs, on recopie directement les pixels.
+void SprSpan_sub_DrawAtlas(u32 nSprFlags, struct SSprite *pSprDesc, u8 *pSpr, upix *pScr, s32 nScrLg, s32 nSprXMin, s32 nSprXMax, s32 nSprYMin, s32 nSprYMax, u32 nHitClr)
+{
+	s32	ix, iy;
+	s32	nX1, nX2, nXClp1, nXClp2;
+	u32	nSpansNb, nLen, i;
+	u32	*pRowOffs;
+	u16	*pSpan;
+	upix	*pPix;
+
+	pRowOffs = (u32 *)pSpr + (nSprFlags & SPR_Flip_X ? pSprDesc->nHt : 0);
+	for (iy = nSprYMin; iy <= nSprYMax; iy++)
+	{
+		// Ligne source (flip y).
+		pSpan = (u16 *)(pSpr + pRowOffs[nSprFlags & SPR_Flip_Y ? pSprDesc->nHt - 1 - iy : iy]);
+		nSpansNb = *pSpan;
+		pPix = (upix *)((u8 *)pSpan + SPRSPAN_ATLAS_HDRSZ(nSpansNb));
+		pSpan++;
+
+		for (i = 0; i < nSpansNb; i++, pSpan += 2, pPix += nLen)
+		{
+			nX1 = pSpan[0];
+			nLen = pSpan[1];
+			if (nX1 > nSprXMax) break;		// Spans tris en x, les suivants sont hors cran.
+			nX2 = nX1 + nLen - 1;
+			if (nX2 < nSprXMin) continue;
+			// Clip.
+			nXClp1 = (nX1 < nSprXMin ? nSprXMin : nX1);
+			nXClp2 = (nX2 > nSprXMax ? nSprXMax : nX2);
+			if (nHitClr == 0)
+				memcpy(pScr + nXClp1, pPix + (nXClp1 - nX1), (nXClp2 - nXClp1 + 1) * sizeof(upix));
+			else
+				for (ix = nXClp1; ix <= nXClp2; ix++)
+					pScr[ix] = pPix[ix - nX1] | nHitClr;
+		}
+
+		pScr += nScrLg;
+	}
+
+}
+
+// Affichage d'un sprite encod.
+// pScr pointe sur la ligne nSprYMin  l'cran, en x = position du bord gauche du sprite.
+// nSprXMin...nSprYMax : Rectangle visible, dans le repre du sprite affich (flips compris).
+// nHitClr : OR sur les pixels opaques (0 pour un affichage normal).
+// Avec cran lock.
+void SprSpanDraw(u32 nSprFlags, struct SSprite *pSprDesc, upix *pScr, s32 nScrLg, s32 nSprXMin, s32 nSprXMax, s32 nSprYMin, s32 nSprYMax, u32 nHitClr)
+{
+	s32	ix, iy;
+	s32	nX1, nX2, nXClp1, nXClp2;
+	u32	nSpansNb, nLen, i;
+	u8	*pSpr, *pIdx;
+	u16	*pSpan;
+	upix	*pPal;
+
+	pSpr = gpSprSpanBuf + gpSprSpanOffs[nSprFlags & ~(SPR_Flip_X | SPR_Flip_Y | SPR_Flag_HitPal)];
+	if (gnSprSpanAtlas)
+	{
+		SprSpan_sub_DrawAtlas(nSprFlags, pSprDesc, pSpr, pScr, nScrLg, nSprXMin, nSprXMax, nSprYMin, nSprYMax, nHitClr);
+		return;
+	}
+	pPal = SprRemapPalGet(pSprDesc->nRemapPalNo);
+
+	for (iy = nSprYMin; iy <= nSprYMax; iy++)
+	{
+		// Ligne source (flip y).
+		pSpan = (u16 *)(pSpr + ((u32 *)pSpr)[nSprFlags & SPR_Flip_Y ? pSprDesc->nHt - 1 - iy : iy]);
+		nSpansNb = *pSpan++;
+		pIdx = (u8 *)(pSpan + (nSpansNb * 2));
+
+		if ((nSprFlags & SPR_Flip_X) == 0)
+		{
+			for (i = 0; i < nSpansNb; i++, pSpan += 2, pIdx += nLen)
+			{
+				nX1 = pSpan[0];
+				nLen = pSpan[1];
+				if (nX1 > nSprXMax) break;		// Spans tris en x, les suivants sont hors cran.
+				nX2 = nX1 + nLen - 1;
+				if (nX2 < nSprXMin) continue;
+				// Clip.
+				nXClp1 = (nX1 < nSprXMin ? nSprXMin : nX1);
+				nXClp2 = (nX2 > nSprXMax ? nSprXMax : nX2);
+				for (ix = nXClp1; ix <= nXClp2; ix++)
+					pScr[ix] = pPal[pIdx[ix - nX1]] | nHitClr;
+			}
+		}
+		else
+		{
+			// Flip x : Le span [x ; x+lg-1] s'affiche en [nLg-x-lg ; nLg-x-1],  l'envers.
+			for (i = 0; i < nSpansNb; i++, pSpan += 2, pIdx += nLen)
+			{
+				nLen = pSpan[1];
+				nX2 = pSprDesc->nLg - 1 - pSpan[0];
+				if (nX2 < nSprXMin) break;		// Spans tris, en flip x les suivants sont plus  gauche.
+				nX1 = nX2 - nLen + 1;
+				if (nX1 > nSprXMax) continue;
+				// Clip.
+				nXClp1 = (nX1 < nSprXMin ? nSprXMin : nX1);
+				nXClp2 = (nX2 > nSprXMax ? nSprXMax : nX2);
+				for (ix = nXClp1; ix <= nXClp2; ix++)
+					pScr[ix] = pPal[pIdx[nX2 - ix]] | nHitClr;
+			}
+		}
+
+		pScr += nScrLg;
+	}
+
+}
+
@@ -0,0 +1,16 @@
+
+#define	SPRSPAN_ON	1	// 1 = sprites encods en spans (pas de masque, pas de cache) / 0 = dpack + masque via le cache.
+
+#ifdef __EMSCRIPTEN__
+#define	SPRSPAN_ATLAS_DEF	0	// Mode par dfaut : index (peu de mmoire).
+#else
+#define	SPRSPAN_ATLAS_DEF	1	// Mode par dfaut : atlas au format cran (pas de conversion au trac).
+#endif
+
+// Prototypes.
+void SprSpanInit(void);
+void SprSpanEncode(void);
+void SprSpanRelease(void);
+void SprSpanAtlasSet(u32 nAtlas);
+void SprSpanDraw(u32 nSprFlags, struct SSprite *pSprDesc, upix *pScr, s32 nScrLg, s32 nSprXMin, s32 nSprXMax, s32 nSprYMin, s32 nSprYMax, u32 nHitClr);
+
@@ -114,15 +114,16 @@ void LineBuf(s32 nX1, s32 nY1, s32 nX2, s32 nY2)
 // Version avec 2 compare par ligne.
 void FaceDraw(void)
 {
-	u16 *pScr;
+	upix *pScr;
 	u32 i;
 	s32	nMinX, nMaxX, nLg;
-	u32	nScrLg = gVar.pScreen->pitch / sizeof(u16);
+	struct SRenderCtx	*pCtx = RCTX();
+	u32	nScrLg = pCtx->nScrPitch;
 
 	if (gTransit2D.nLnYMin > gTransit2D.nLnYMax) return;	// Rien  tracer.
 
 //pitch//	pScr = (u16 *)gVar.pScreen->pixels + (gTransit2D.nLnYMin * SCR_Width);
-	pScr = (u16 *)(gVar.pScreen->pixels + (gTransit2D.nLnYMin * gVar.pScreen->pitch));
+	pScr = pCtx->pScr + (gTransit2D.nLnYMin * nScrLg);
 	for (i = gTransit2D.nLnYMin; i <= gTransit2D.nLnYMax; i++)
 	{
 		nMinX = gTransit2D.pLnBufL[i];
@@ -214,8 +215,6 @@ void T0_DrawFaces(void)
 {
 	u32	i;
 
-	SDL_LockSurface(gVar.pScreen);
-
 	for (i = 0; i < T0_FACES_NB; i++)
 	{
 		// Face normale.
@@ -232,7 +231,6 @@ void T0_DrawFaces(void)
 		FaceDraw();
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
 
 }
 
@@ -385,8 +383,6 @@ void T1_DrawFaces(void)
 {
 	u32	i;
 
-	SDL_LockSurface(gVar.pScreen);
-
 	for (i = 0; i < T1_FACES_NB/2; i++)
 	{
 		LinesBufferClear();
@@ -404,7 +400,6 @@ void T1_DrawFaces(void)
 		FaceDraw();
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
 
 }
 
@@ -481,8 +476,6 @@ void T2H_DrawFaces(void)
 	s32	nOffsX, nOffsY;
 	s32	d, d2;
 
-	SDL_LockSurface(gVar.pScreen);
-
 	nOffsY = (2 * T2_UNIT2D) / 3;
 	for (i = -4; i <= 4; i++)
 	{
@@ -519,7 +512,6 @@ void T2H_DrawFaces(void)
 		FaceDraw();
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
 
 }
 
@@ -530,8 +522,6 @@ void T2V_DrawFaces(void)
 	s32	nOffsX, nOffsY;
 	s32	d, d2;
 
-	SDL_LockSurface(gVar.pScreen);
-
 	nOffsX = (2 * T2_UNIT2D) / 3;
 	for (i = -3; i <= 3; i++)
 	{
@@ -568,7 +558,6 @@ void T2V_DrawFaces(void)
 		FaceDraw();
 	}
 
-	SDL_UnlockSurface(gVar.pScreen);
 
 }
 
@@ -643,7 +632,6 @@ void T3_DrawFaces(u32 nFillRight)
 	s32	nOffsX = -(3*(T3_STRIPE_SZ+1)) -16;// -8;//0;
 	s32	nDiff;
 
-	SDL_LockSurface(gVar.pScreen);
 	if (nFillRight)
 	{
 		for (i = 0; i < T3_STRIPE_NB+3; i++, nOffsX += T3_STRIPE_SZ+1)
@@ -694,7 +682,6 @@ void T3_DrawFaces(u32 nFillRight)
 			FaceDraw();
 		}
 	}
-	SDL_UnlockSurface(gVar.pScreen);
 
 }
 
@@ -779,4 +766,9 @@ void Transit2D_Manage(void)
 
 }
 
+// Snapshots : Transition en cours.
+void Transit2DSnapZones(void)
+{
+	SnapZoneAdd(&gTransit2D, sizeof(gTransit2D), NULL, NULL);
+}
 
@@ -18,4 +18,5 @@ void Transit2D_Manage(void);
 
 void Transit2D_Reset(void);
 u32 Transit2D_CheckEnd(void);
+void Transit2DSnapZones(void);
 